@@ -0,0 +1,88 @@
+#include "serial_frame.h"
+
+/* INTERNAL */
+
+/// Add a byte to a CRC-8 with the polynomial 0x07
+static uint8_t crc8_update(uint8_t crc, uint8_t byte) {
+	crc ^= byte;
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+/// Wait for the next frame. A byte which was expected to be part of a frame,
+/// but isn't, may be the start of the next one.
+static void decoder_resync(SerialFrameDecoder *decoder, uint8_t byte) {
+	decoder->crc = 0;
+	decoder->next = (byte == SERIAL_FRAME_SYNC) ? SERIAL_FRAME_FIELD_COMMAND : SERIAL_FRAME_FIELD_SYNC;
+}
+
+/* EXTERNAL */
+
+// cppcheck-suppress unusedFunction
+void serial_frame_decoder_init(SerialFrameDecoder *decoder) {
+	decoder->next = SERIAL_FRAME_FIELD_SYNC;
+	decoder->received = 0;
+	decoder->crc = 0;
+}
+
+// cppcheck-suppress unusedFunction
+bool serial_frame_decode(SerialFrameDecoder *decoder, uint8_t byte) {
+	SerialFrame *frame = &decoder->frame;
+
+	switch (decoder->next) {
+		case SERIAL_FRAME_FIELD_SYNC:
+			decoder_resync(decoder, byte);
+			break;
+		case SERIAL_FRAME_FIELD_COMMAND:
+			frame->command = byte;
+			decoder->crc = crc8_update(decoder->crc, byte);
+			decoder->next = SERIAL_FRAME_FIELD_LEN;
+			break;
+		case SERIAL_FRAME_FIELD_LEN:
+			// Resync: No valid frame is this long
+			if (byte > SERIAL_FRAME_PAYLOAD_MAX) {
+				decoder_resync(decoder, byte);
+				break;
+			}
+			frame->len = byte;
+			decoder->received = 0;
+			decoder->crc = crc8_update(decoder->crc, byte);
+			decoder->next = (byte == 0) ? SERIAL_FRAME_FIELD_CRC : SERIAL_FRAME_FIELD_PAYLOAD;
+			break;
+		case SERIAL_FRAME_FIELD_PAYLOAD:
+			frame->payload[decoder->received++] = byte;
+			decoder->crc = crc8_update(decoder->crc, byte);
+			if (decoder->received == frame->len) {
+				decoder->next = SERIAL_FRAME_FIELD_CRC;
+			}
+			break;
+		case SERIAL_FRAME_FIELD_CRC:
+			if (byte == decoder->crc) {
+				decoder->next = SERIAL_FRAME_FIELD_SYNC;
+				return true;
+			}
+			decoder_resync(decoder, byte);
+			break;
+	}
+
+	return false;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t serial_frame_encode(uint8_t *out, uint8_t command, const uint8_t *payload, uint8_t len) {
+	uint8_t crc = crc8_update(0, command);
+	crc = crc8_update(crc, len);
+
+	uint8_t i = 0;
+	out[i++] = SERIAL_FRAME_SYNC;
+	out[i++] = command;
+	out[i++] = len;
+	for (uint8_t p = 0; p < len; p++) {
+		out[i++] = payload[p];
+		crc = crc8_update(crc, payload[p]);
+	}
+	out[i++] = crc;
+	return i;
+}
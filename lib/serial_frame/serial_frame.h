@@ -0,0 +1,73 @@
+#ifndef SERIAL_FRAME_H_
+#define SERIAL_FRAME_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Frames carry a command and a short payload over a byte stream, such as a
+ * serial port. Each frame is laid out as:
+ *
+ *   SYNC | COMMAND | LEN | PAYLOAD (LEN bytes) | CRC
+ *
+ * The CRC is a CRC-8 (polynomial 0x07, initial value 0) of the command, length
+ * and payload bytes. A receiver which loses its place, or receives a corrupt
+ * frame, discards bytes until the next sync byte. The bytes of a frame that was
+ * cut short are taken as the rest of it, so the frame after it can be lost too.
+ * A sender should resend a frame that isn't answered.
+ */
+
+#define SERIAL_FRAME_SYNC 0xA5
+/// Largest payload a frame can carry
+#define SERIAL_FRAME_PAYLOAD_MAX 16
+/// Bytes in a frame in addition to its payload
+#define SERIAL_FRAME_OVERHEAD 4
+
+typedef struct SerialFrame {
+	uint8_t command;
+	/// Number of bytes in `payload`
+	uint8_t len;
+	uint8_t payload[SERIAL_FRAME_PAYLOAD_MAX];
+} SerialFrame;
+
+/// Which part of a frame the decoder expects next
+typedef enum SerialFrameField {
+	SERIAL_FRAME_FIELD_SYNC,
+	SERIAL_FRAME_FIELD_COMMAND,
+	SERIAL_FRAME_FIELD_LEN,
+	SERIAL_FRAME_FIELD_PAYLOAD,
+	SERIAL_FRAME_FIELD_CRC,
+} SerialFrameField;
+
+/// Decodes frames one byte at a time, so that it never has to wait for the rest
+/// of a frame to arrive.
+typedef struct SerialFrameDecoder {
+	/// The frame being received. Holds a complete frame once
+	/// `serial_frame_decode()` returns `true`, until the next byte is decoded.
+	SerialFrame frame;
+	SerialFrameField next;
+	/// Payload bytes received so far
+	uint8_t received;
+	/// CRC of the bytes received so far
+	uint8_t crc;
+} SerialFrameDecoder;
+
+void serial_frame_decoder_init(SerialFrameDecoder *decoder);
+
+/// Feed the next received byte to the decoder.
+/// @return `true` if the byte completed a valid frame, which is stored in
+/// `decoder->frame`.
+bool serial_frame_decode(SerialFrameDecoder *decoder, uint8_t byte);
+
+/// Encode a frame into `out`.
+/// @param out Must hold at least `len + SERIAL_FRAME_OVERHEAD` bytes.
+/// @param len Must be at most `SERIAL_FRAME_PAYLOAD_MAX`.
+/// @return Number of bytes written to `out`.
+uint8_t serial_frame_encode(uint8_t *out, uint8_t command, const uint8_t *payload, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SERIAL_FRAME_H_ */
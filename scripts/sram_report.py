@@ -0,0 +1,62 @@
+"""Print the static SRAM used by each module after the firmware is linked.
+
+Static SRAM is the .data, .rodata and .bss sections of each object file. On AVR,
+constant data which isn't marked PROGMEM is copied into SRAM at startup, so it
+is counted too. The stack is not included. Sections which the linker drops
+because they are unused are still counted, so each module's size is an upper
+bound. The total is read from the linked firmware.
+"""
+
+import os
+import subprocess
+
+Import("env")  # noqa: F821
+
+SRAM_SIZE = 2048
+SRAM_SECTIONS = (".data", ".rodata", ".bss")
+
+
+def section_sizes(size_tool, path):
+    """Sizes of the SRAM sections in an object or ELF file, in bytes"""
+    output = subprocess.run([size_tool, "-A", path], capture_output=True, text=True).stdout
+    sizes = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) < 2 or not fields[1].isdigit():
+            continue
+        for section in SRAM_SECTIONS:
+            if fields[0] == section or fields[0].startswith(section + "."):
+                sizes[section] = sizes.get(section, 0) + int(fields[1])
+    return sizes
+
+
+def sram_report(source, target, env):
+    build_dir = env.subst("$BUILD_DIR")
+    size_tool = env.subst("$SIZETOOL")
+
+    modules = []
+    for root, _, files in os.walk(build_dir):
+        for name in files:
+            if not name.endswith(".o"):
+                continue
+            path = os.path.join(root, name)
+            sizes = section_sizes(size_tool, path)
+            total = sum(sizes.values())
+            if total:
+                modules.append((total, sizes, os.path.relpath(path, build_dir)))
+    modules.sort(reverse=True)
+
+    print("SRAM usage by module (bytes):")
+    print("%6s %6s %6s %6s  %s" % ("total", "data", "rodata", "bss", "module"))
+    for total, sizes, module in modules:
+        print(
+            "%6d %6d %6d %6d  %s"
+            % (total, sizes.get(".data", 0), sizes.get(".rodata", 0), sizes.get(".bss", 0), module)
+        )
+
+    firmware = section_sizes(size_tool, str(target[0]))
+    used = sum(firmware.values())
+    print("Static SRAM: %d of %d bytes, %d bytes free for the stack" % (used, SRAM_SIZE, SRAM_SIZE - used))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", sram_report)  # noqa: F821
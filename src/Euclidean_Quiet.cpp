@@ -3,21 +3,26 @@
 #include <Arduino.h>
 
 #include "common/params.h"
+#include "common/timeout.h"
 #include "common/types.h"
 #include "hardware/eeprom.h"
 #include "hardware/input.h"
 #include "hardware/led.h"
 #include "hardware/output.h"
 #include "hardware/properties.h"
+#include "hardware/trig_monitor.h"
 #include "logging.h"
 #include "mode/clock.h"
 #include "mode/euclid.h"
 #include "mode/mode.h"
 #include "mode/state.h"
+#include "remote.h"
+#include "scheduler.h"
 #include "ui/framebuffer.h"
 #include "ui/framebuffer_led.h"
 #include "ui/indicators.h"
 #include "ui/led_sleep.h"
+#include "ui/perf_overlay.h"
 
 /* GLOBALS */
 
@@ -30,24 +35,84 @@ static Params params;
 
 Framebuffer framebuffer;
 
+/// Earliest time at which the active mode or the input indicators have a
+/// timeout that will fire. Until then, they only need to be updated when there
+/// are input events.
+static Milliseconds next_deadline;
+
+/// Input events received by the most recent run of the input task
+static InputEvents events_in;
+
+/// Set when external input events are received, until the LED sleep task has
+/// handled them.
+static bool postpone_sleep;
+
+/// Set when the LED matrix wakes from sleep, until the display task has
+/// resynced it.
+static bool display_woke;
+
+/// Restarted whenever a param is modified. Params are only written to EEPROM
+/// once it fires, so sweeping a knob results in a single write.
+static Timeout eeprom_settle_timeout = {.duration = EEPROM_SETTLE_TIME};
+
+/// The LED matrix is initialized on the first idle cycle rather than during
+/// `setup()`, so the sequencer can respond to trigs sooner after power-on.
+static bool led_initialized;
+/// Whether every row of the first frame has been sent to the LED matrix
+static bool first_frame_shown;
+
 /* DECLARATIONS */
 
 static void active_mode_switch(Mode mode);
-/// Clear `PARAM_FLAG_MODIFIED` for all parameters
-static void params_reset_modified_flag(Params *params, Mode mode);
+
+static void task_input(Milliseconds now);
+static void task_sequencer(Milliseconds now);
+static void task_display(Milliseconds now);
+static void task_led_sleep(Milliseconds now);
+static void task_eeprom(Milliseconds now);
+#if SERIAL_REMOTE
+static void task_remote(Milliseconds now);
+#endif
+
+/// Is a trig waiting to be read, or is a clock edge or sequencer deadline due
+/// within `margin` milliseconds? Work that can wait should hold off if so.
+static bool clock_edge_imminent(Milliseconds margin);
+
+/* TASKS */
+
+/// Tasks run by the scheduler every cycle, in priority order. Periods are in
+/// milliseconds, budgets are in microseconds.
+// clang-format off
+static Task tasks[] = {
+	{.run = task_input,     .release = {.duration = 0},  .budget = 600,                    .critical = true},
+	{.run = task_sequencer, .release = {.duration = 0},  .budget = 500,                    .critical = true},
+	{.run = task_display,   .release = {.duration = 0},  .budget = DISPLAY_REFRESH_BUDGET, .critical = false},
+	{.run = task_led_sleep, .release = {.duration = 20}, .budget = 400,                    .critical = false},
+	{.run = task_eeprom,    .release = {.duration = 0},  .budget = 300,                    .critical = false},
+#if SERIAL_REMOTE
+	{.run = task_remote,    .release = {.duration = 0},  .budget = 400,                    .critical = false},
+#endif
+};
+// clang-format on
+#define NUM_TASKS (sizeof(tasks) / sizeof(tasks[0]))
 
 /* MAIN */
 
 void setup() {
 	const Milliseconds now = millis();
 
+	// Stages are ordered so that trigs reach the outputs as soon as possible.
+	// The LED matrix is initialized later, by the display task.
 	logging_init();
-	led_init();
-	led_sleep_init(now);
-	input_init();
 	output_init();
+	input_init();
+	trig_monitor_init();
+	remote_init();
+	led_sleep_init(now);
+	log_boot_stage(BOOT_STAGE_IO);
 
 	active_mode_switch(MODE_EUCLID);
+	log_boot_stage(BOOT_STAGE_MODE_INIT);
 }
 
 void loop() {
@@ -55,51 +120,174 @@ void loop() {
 
 	log_cycle_time_begin();
 
+	scheduler_run(tasks, NUM_TASKS, now);
+	perf_overlay_update(&framebuffer, tasks, NUM_TASKS, now);
+	log_task_deadline_misses(tasks, NUM_TASKS, now);
+	log_trig_monitor(now);
+	log_trig_output_latency(now);
+	log_led_rows(now);
+	log_channel_redraws(now);
+	log_suppressed_writes(now);
+	log_loop_stages();
+
+	log_cycle_time_end(now);
+}
+
+/* INTERNAL */
+
+static void active_mode_switch(Mode mode) {
+	active_mode = mode;
+
+	eeprom_params_load(&params, mode);
+	log_boot_stage(BOOT_STAGE_PARAMS_LOAD);
+	mode_params_validate(&params, mode);
+	log_boot_stage(BOOT_STAGE_PARAMS_VALIDATE);
+
+	mode_init(&mode_state, &params, &framebuffer, mode);
+
+	// Update the new mode on the next cycle, regardless of events
+	next_deadline = millis();
+}
+
+static void task_input(Milliseconds now) {
 	// Input Events
-	InputEvents events_in = INPUT_EVENTS_EMPTY;
+	LOOP_STAGE_BEGIN();
+	input_events_clear(&events_in);
 	input_update(&events_in, now);
+	LOOP_STAGE_END(LOOP_STAGE_INPUT);
 	log_input_events(&events_in);
 
 	// Update Internal Clock
+	LOOP_STAGE_BEGIN();
 	internal_clock_update(&events_in, now);
+	LOOP_STAGE_END(LOOP_STAGE_CLOCK);
+
+	postpone_sleep |= input_events_contains_any_external(&events_in);
+}
+
+static void task_sequencer(Milliseconds now) {
+	// Skip the stages that only react to events and timeouts if nothing is due
+	const bool events_pending = input_events_contains_any(&events_in);
+	if (!events_pending && !deadline_reached(next_deadline, now)) return;
 
 	// Update Active Mode
-	params_reset_modified_flag(&params, active_mode);
+	LOOP_STAGE_BEGIN();
+	params_flags_clear_all(&params, PARAM_FLAG_MODIFIED);
 	mode_update(&mode_state, &params, &framebuffer, active_mode, &events_in, now);
+	LOOP_STAGE_END(LOOP_STAGE_MODE_UPDATE);
+	log_trig_output_latency_record(events_in.trig);
 	log_all_modified_params(&params, active_mode);
+	if (params_flags_any(&params, PARAM_FLAG_MODIFIED)) {
+		timeout_reset(&eeprom_settle_timeout, now);
+	}
+	if (events_in.trig) {
+		trig_monitor_record_consumed();
+		perf_overlay_record_trig_latency(micros() - input_trig_time());
+	}
 
 	// Drawing - Input Indicators
+	LOOP_STAGE_BEGIN();
 	indicators_input_draw(&framebuffer, &events_in, now);
+	LOOP_STAGE_END(LOOP_STAGE_INDICATORS);
+
+	const Milliseconds mode_deadline = mode_next_deadline(&mode_state, active_mode, now);
+	next_deadline = deadline_earliest(mode_deadline, indicators_next_deadline(now), now);
+}
 
-	// Update LED Display
-	framebuffer_update_color_animations(now);
-	framebuffer_copy_row_to_display(&framebuffer);
+static void task_display(Milliseconds now) {
+	// The LED matrix is shut down while asleep, so there is nothing to animate or
+	// send to it. Dirty rows build up until it wakes.
+	if (led_sleep_asleep()) return;
 
-	// Update LED Sleep
-	const bool postpone_sleep = input_events_contains_any_external(&events_in);
-	led_sleep_update(postpone_sleep, now);
+	if (display_woke) {
+		display_woke = false;
+		// Resend every row, even those whose shadow copy matches
+		framebuffer_display_resync(&framebuffer);
+		// Draw anything the active mode held back while asleep
+		next_deadline = now;
+	}
 
-	// EEPROM Writes
-	eeprom_save_all_needing_write(&params, active_mode);
+	if (!led_initialized) {
+		// Early return: Wait for an idle cycle
+		if (clock_edge_imminent(DISPLAY_YIELD_MARGIN)) return;
 
-	log_cycle_time_end(now);
+		led_init();
+		led_initialized = true;
+		// Every row is sent, even those that were never drawn into
+		framebuffer_display_resync(&framebuffer);
+		log_boot_stage(BOOT_STAGE_LED_INIT);
+		return;
+	}
+
+	LOOP_STAGE_BEGIN();
+	framebuffer_update_color_animations(&framebuffer, now);
+	LOOP_STAGE_END(LOOP_STAGE_ANIMATIONS);
+
+	// Send as many rows as fit in the budget, assuming each row takes as long as
+	// the one before it
+	LOOP_STAGE_BEGIN();
+	const Microseconds start = micros();
+	Microseconds elapsed = 0;
+	Microseconds row_time = 0;
+	while (elapsed + row_time <= DISPLAY_REFRESH_BUDGET) {
+		if (clock_edge_imminent(DISPLAY_YIELD_MARGIN)) break;
+		if (!framebuffer_copy_row_to_display(&framebuffer)) {
+			if (!first_frame_shown) {
+				first_frame_shown = true;
+				log_boot_stage(BOOT_STAGE_FIRST_FRAME);
+			}
+			break;
+		}
+
+		const Microseconds elapsed_now = micros() - start;
+		row_time = elapsed_now - elapsed;
+		elapsed = elapsed_now;
+	}
+	LOOP_STAGE_END(LOOP_STAGE_LED_COPY);
+	log_led_refresh(elapsed);
 }
 
-/* INTERNAL */
+static void task_led_sleep(Milliseconds now) {
+	// Early return: The LED matrix can't be dimmed or shut down until it has been
+	// set up
+	if (!led_initialized) return;
 
-static void active_mode_switch(Mode mode) {
-	active_mode = mode;
+	LOOP_STAGE_BEGIN();
+	const bool woke = led_sleep_update(postpone_sleep, now);
+	LOOP_STAGE_END(LOOP_STAGE_SLEEP);
+	postpone_sleep = false;
 
-	eeprom_params_load(&params, mode);
-	mode_params_validate(&params, mode);
+	// The display task resyncs the LED matrix, so this task stays short
+	display_woke |= woke;
+}
 
-	mode_init(&mode_state, &params, &framebuffer, mode);
+static bool clock_edge_imminent(Milliseconds margin) {
+	if (input_trig_pending()) return true;
+
+	const Milliseconds now = millis();
+	const Milliseconds horizon = now + margin;
+	return deadline_reached(next_deadline, horizon) ||
+	       deadline_reached(internal_clock_next_tick(now), horizon) ||
+	       deadline_reached(external_clock_next_trig(now), horizon);
 }
 
-void params_reset_modified_flag(Params *params, Mode mode) {
-	const uint8_t num_params = mode_num_params[mode];
+static void task_eeprom(Milliseconds now) {
+	if (!params_flags_any(&params, PARAM_FLAG_NEEDS_WRITE)) return;
+	if (!timeout_fired(&eeprom_settle_timeout, now)) return;
+
+	// Writes are queued and programmed in the background, so this doesn't wait
+	// on the EEPROM
+	LOOP_STAGE_BEGIN();
+	eeprom_save_all_needing_write(&params, active_mode);
+	LOOP_STAGE_END(LOOP_STAGE_EEPROM);
+}
 
-	for (uint8_t idx = 0; idx < num_params; idx++) {
-		param_flags_clear(params, idx, PARAM_FLAG_MODIFIED);
+#if SERIAL_REMOTE
+static void task_remote(Milliseconds now) {
+	if (remote_update(&mode_state, &params, active_mode)) {
+		timeout_reset(&eeprom_settle_timeout, now);
+		// Draw the written params
+		next_deadline = now;
 	}
 }
+#endif
@@ -1,6 +1,9 @@
 #include "events.h"
 
-const InputEvents INPUT_EVENTS_EMPTY = {
+#include <avr/pgmspace.h>
+
+/// An instance of `InputEvents` which represents no events happening
+static const InputEvents INPUT_EVENTS_EMPTY PROGMEM = {
     .enc_move = {0, 0, 0},
     .enc_push = ENCODER_NONE,
     .trig = false,
@@ -8,6 +11,9 @@ const InputEvents INPUT_EVENTS_EMPTY = {
     .internal_clock_tick = false,
 };
 
+// cppcheck-suppress unusedFunction
+void input_events_clear(InputEvents *events) { memcpy_P(events, &INPUT_EVENTS_EMPTY, sizeof(*events)); }
+
 // cppcheck-suppress unusedFunction
 bool input_events_contains_any_external(const InputEvents *events) {
 	if (!events) return false;
@@ -22,3 +28,10 @@ bool input_events_contains_any_external(const InputEvents *events) {
 	// clang-format on
 	return result;
 }
+
+// cppcheck-suppress unusedFunction
+bool input_events_contains_any(const InputEvents *events) {
+	if (!events) return false;
+
+	return (events->internal_clock_tick || input_events_contains_any_external(events));
+}
@@ -24,12 +24,15 @@ typedef struct InputEvents {
 	bool internal_clock_tick;
 } InputEvents;
 
-/// An instance of `InputEvents` which represents no events happening
-extern const InputEvents INPUT_EVENTS_EMPTY;
+/// Reset `events` to represent no events happening
+void input_events_clear(InputEvents *events);
 
 /// Returns true if `events` contains any externally-generated events
 bool input_events_contains_any_external(const InputEvents *events);
 
+/// Returns true if `events` contains any events at all, including internally-generated ones
+bool input_events_contains_any(const InputEvents *events);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,16 +1,127 @@
 #include "params.h"
 
+#include "common/math.h"
+
+/* DECLARATIONS */
+
+/// Largest value the param described by `info` may currently have, which may
+/// depend on the value of another param
+static uint8_t param_max(const Params *params, const ParamInfo *info);
+
 /* EXTERNAL */
 
-void param_and_flags_set(Params *params, ParamIdx idx, uint8_t value) {
+bool param_and_flags_set(Params *params, ParamIdx idx, uint8_t value) {
+	// Early return: Writing the same value would only cause work downstream
+	if (params->values[idx] == value) return false;
+
 	params->values[idx] = value;
 	param_flags_set(params, idx, (PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE));
+	return true;
 }
 
 uint8_t param_flags_get(const Params *params, ParamIdx idx, uint8_t mask) {
-	return (params->flags[idx] & mask);
+	const ParamBits bit = (ParamBits)1 << idx;
+	uint8_t result = PARAM_FLAGS_NONE;
+	if (params->modified & bit) {
+		result |= PARAM_FLAG_MODIFIED;
+	}
+	if (params->needs_write & bit) {
+		result |= PARAM_FLAG_NEEDS_WRITE;
+	}
+	return (result & mask);
 }
 
-void param_flags_set(Params *params, ParamIdx idx, uint8_t mask) { params->flags[idx] |= mask; }
+void param_flags_set(Params *params, ParamIdx idx, uint8_t mask) {
+	const ParamBits bit = (ParamBits)1 << idx;
+	if (mask & PARAM_FLAG_MODIFIED) {
+		params->modified |= bit;
+	}
+	if (mask & PARAM_FLAG_NEEDS_WRITE) {
+		params->needs_write |= bit;
+	}
+}
+
+void param_flags_clear(Params *params, ParamIdx idx, uint8_t mask) {
+	const ParamBits bit = (ParamBits)1 << idx;
+	if (mask & PARAM_FLAG_MODIFIED) {
+		params->modified &= ~bit;
+	}
+	if (mask & PARAM_FLAG_NEEDS_WRITE) {
+		params->needs_write &= ~bit;
+	}
+}
+
+uint8_t params_flags_any(const Params *params, uint8_t mask) {
+	return (params_flags_bits(params, mask)) ? mask : PARAM_FLAGS_NONE;
+}
+
+void params_flags_clear_all(Params *params, uint8_t mask) {
+	if (mask & PARAM_FLAG_MODIFIED) {
+		params->modified = 0;
+	}
+	if (mask & PARAM_FLAG_NEEDS_WRITE) {
+		params->needs_write = 0;
+	}
+}
+
+ParamBits params_flags_bits(const Params *params, uint8_t mask) {
+	ParamBits result = 0;
+	if (mask & PARAM_FLAG_MODIFIED) {
+		result |= params->modified;
+	}
+	if (mask & PARAM_FLAG_NEEDS_WRITE) {
+		result |= params->needs_write;
+	}
+	return result;
+}
 
-void param_flags_clear(Params *params, ParamIdx idx, uint8_t mask) { params->flags[idx] &= ~mask; }
+// cppcheck-suppress unusedFunction
+void params_validate(Params *params, const ParamInfo *infos) {
+	// Params are visited in order, so any param bounding another has already
+	// been validated when it is used
+	for (ParamIdx idx = 0; idx < params->len; idx++) {
+		ParamInfo info;
+		param_info_read(&info, &infos[idx]);
+
+		const uint8_t max = param_max(params, &info);
+		const uint8_t value = params->values[idx];
+		if ((value < info.min) || (value > max)) {
+			params->values[idx] = MIN(info.default_value, max);
+		}
+	}
+}
+
+// cppcheck-suppress unusedFunction
+bool param_adjust(Params *params, const ParamInfo *infos, ParamIdx idx, int16_t delta) {
+	ParamInfo info;
+	param_info_read(&info, &infos[idx]);
+
+	const int16_t value = (int16_t)params->values[idx] + delta;
+	bool changed = param_and_flags_set(params, idx, (uint8_t)CONSTRAIN(value, info.min, param_max(params, &info)));
+
+	// Early return: Other params can only depend on this one if it changed
+	if (!changed) return false;
+
+	for (ParamIdx dependent = idx + 1; dependent < params->len; dependent++) {
+		ParamInfo dependent_info;
+		param_info_read(&dependent_info, &infos[dependent]);
+		if (dependent_info.bound_by != idx) continue;
+
+		const uint8_t max = param_max(params, &dependent_info);
+		if (params->values[dependent] > max) {
+			param_and_flags_set(params, dependent, max);
+		}
+	}
+	return true;
+}
+
+/* INTERNAL */
+
+static uint8_t param_max(const Params *params, const ParamInfo *info) {
+	// Early return: Fixed bounds
+	if (info->bound_by == PARAM_IDX_NONE) return info->max;
+
+	const uint8_t bound = params->values[info->bound_by];
+	const uint8_t bound_max = (bound > info->bound_margin) ? (bound - info->bound_margin) : 0;
+	return MIN(info->max, bound_max);
+}
@@ -22,28 +22,92 @@ extern "C" {
 /// `ParamId` type for any mode.
 #define PARAMS_MAX 9
 
-/// Parameter properties which need to be modified at runtime. Each table has
-/// the same length (`.len`), and they are indexed by a mode's associated
-/// `ParamId` type.
+/// Length of a parameter's name, including the null terminator
+#define PARAM_NAME_LEN 3
+
+/// Value of `ParamInfo.bound_by` for parameters whose bounds are fixed
+#define PARAM_IDX_NONE 0xFF
+
+/// A set of parameters, stored as bitflags indexed by `ParamIdx`. Must have at
+/// least `PARAMS_MAX` bits.
+typedef uint16_t ParamBits;
+
+/// Parameter properties which need to be modified at runtime. Tables are
+/// indexed by a mode's associated `ParamId` type.
+///
+/// Each `PARAM_FLAG_*` flag is stored as a bitset, so checking whether any
+/// parameter has a flag is a single compare, and the parameters that do can be
+/// visited without walking the tables.
 typedef struct Params {
 	/// Number of elements in tables
 	uint8_t len;
 	/// List of parameter values of length `.len`. The values are always assumed to be in bounds.
 	uint8_t values[PARAMS_MAX];
-	/// List of parameter properties, stored as bitflags, of length `.len`. Bitflags are indexed
-	/// via `PARAM_FLAG_*` defines.
-	uint8_t flags[PARAMS_MAX];
+	/// Parameters with `PARAM_FLAG_MODIFIED` set
+	ParamBits modified;
+	/// Parameters with `PARAM_FLAG_NEEDS_WRITE` set
+	ParamBits needs_write;
 } Params;
 
+/// Static information about a parameter. Each mode has a table of these in
+/// flash, indexed by its `ParamId` type, which drives validation, adjustment,
+/// EEPROM storage and logging of its parameters.
+typedef struct ParamInfo {
+	/// EEPROM address the parameter is stored at
+	Address addr;
+	uint8_t min;
+	uint8_t max;
+	/// Value used when the stored value is out of bounds
+	uint8_t default_value;
+	/// Parameter whose value also bounds this parameter's maximum, or
+	/// `PARAM_IDX_NONE`. It must have a lower index than this parameter.
+	ParamIdx bound_by;
+	/// Subtracted from the value of the `bound_by` parameter to get this
+	/// parameter's maximum
+	uint8_t bound_margin;
+	/// Null-terminated name, for logging
+	char name[PARAM_NAME_LEN];
+} ParamInfo;
+
+/// Copy a `ParamInfo` out of a table in flash. Implemented in `mode.c`, next to
+/// the tables, so that this module doesn't depend on how flash is read.
+void param_info_read(ParamInfo *result, const ParamInfo *info);
+
 /// Set the param referenced by `idx` to `value`, and set its flags to indicate
-/// that it has been modified and needs to be written to the EEPROM.
-void param_and_flags_set(Params *params, ParamIdx idx, uint8_t value);
+/// that it has been modified and needs to be written to the EEPROM. If the
+/// param already has this value, nothing is changed.
+/// @return `true` if the param's value changed. Callers count the writes that
+/// were suppressed because it didn't.
+bool param_and_flags_set(Params *params, ParamIdx idx, uint8_t value);
 /// Read the bits specified in `mask`
 uint8_t param_flags_get(const Params *params, ParamIdx idx, uint8_t mask);
 /// Set the bits specified in `mask` to 1, leaving the others untouched
 void param_flags_set(Params *params, ParamIdx idx, uint8_t mask);
 /// Clear the bits specified in `mask` to 0, leaving the others untouched
 void param_flags_clear(Params *params, ParamIdx idx, uint8_t mask);
+/// Read the bits specified in `mask` which are set for at least one parameter
+uint8_t params_flags_any(const Params *params, uint8_t mask);
+/// Clear the bits specified in `mask` to 0 for every parameter
+void params_flags_clear_all(Params *params, uint8_t mask);
+/// The set of parameters which have any of the bits specified in `mask` set
+ParamBits params_flags_bits(const Params *params, uint8_t mask);
+
+/// Replace every param which is out of the bounds described by `infos` with
+/// its default value. Doesn't set any flags.
+/// @param infos Table of `params->len` elements, stored in flash.
+void params_validate(Params *params, const ParamInfo *infos);
+
+/// Add `delta` to the param referenced by `idx`, constrained to the bounds
+/// described by `infos`. Params bounded by this one are constrained to their
+/// new bounds. Flags are set as with `param_and_flags_set()`.
+/// @param infos Table of `params->len` elements, stored in flash.
+/// @return `true` if any param's value changed.
+bool param_adjust(Params *params, const ParamInfo *infos, ParamIdx idx, int16_t delta);
+
+/// Index of the first parameter in `bits`. Loop over every parameter in a set
+/// by clearing the first one with `bits &= bits - 1`.
+/// @param bits Must contain at least one parameter.
+static inline ParamIdx param_bits_first(ParamBits bits) { return (ParamIdx)__builtin_ctz(bits); }
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,8 @@
 
 void timeout_reset(Timeout *timeout, Milliseconds now) { timeout->start = now; }
 
+Milliseconds timeout_deadline(const Timeout *timeout) { return timeout->start + timeout->duration; }
+
 bool timeout_fired(const Timeout *timeout, Milliseconds now) {
 	return ((now - timeout->start) >= timeout->duration);
 }
@@ -31,4 +33,12 @@ bool timeout_once_fired(TimeoutOnce *timeout_once, Milliseconds now) {
 		return val;
 	}
 	return false;
+}
+
+// cppcheck-suppress unusedFunction
+bool deadline_reached(Milliseconds deadline, Milliseconds now) { return ((long)(now - deadline) >= 0); }
+
+// cppcheck-suppress unusedFunction
+Milliseconds deadline_earliest(Milliseconds a, Milliseconds b, Milliseconds now) {
+	return ((long)(a - now) < (long)(b - now)) ? a : b;
 }
\ No newline at end of file
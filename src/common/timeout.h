@@ -20,6 +20,9 @@ typedef struct Timeout {
 /// Make the timeout start again at `now`.
 void timeout_reset(Timeout *timeout, Milliseconds now);
 
+/// The time at which the timeout will be considered fired
+Milliseconds timeout_deadline(const Timeout *timeout);
+
 /// Check if the timeout has fired, given the current time, `now`
 bool timeout_fired(const Timeout *timeout, Milliseconds now);
 
@@ -42,6 +45,20 @@ void timeout_once_reset(TimeoutOnce *timeout_once, Milliseconds now);
 /// `true` if this is the first time after the timer has fired.
 bool timeout_once_fired(TimeoutOnce *timeout_once, Milliseconds now);
 
+/* DEADLINES */
+
+/// Used as the deadline when nothing is scheduled, relative to the current
+/// time. Keeps deadlines well within the range where comparisons are safe
+/// across `millis()` rollover.
+#define DEADLINE_NONE_INTERVAL 60000
+
+/// Check if `deadline` is at or before `now`. Handles `millis()` rollover.
+bool deadline_reached(Milliseconds deadline, Milliseconds now);
+
+/// Returns whichever of the deadlines `a` and `b` will be reached first, given
+/// the current time, `now`.
+Milliseconds deadline_earliest(Milliseconds a, Milliseconds b, Milliseconds now);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,7 @@ extern "C" {
 #define LED_BRIGHTNESS 5 // From 0 (low) to 15
 #define LED_BRIGHTNESS_DIM 1 // From 0 (low) to 15
 #define ADJUSTMENT_DISPLAY_TIME 450 // How long adjustments (such as to channel pattern length) are displayed for
+#define PRESET_STORE_ARM_TIME 1500 // Milliseconds after turning the Offset knob on the preset page that turning it again stores the preset
 #define LED_DIM_TIME 240000 // Milliseconds until LED matrix dims (4 minutes)
 #define LED_SLEEP_TIME 300000 // Milliseconds until LED matrix sleeps (5 minutes)
 #define INPUT_INDICATOR_FLASH_TIME 16 // Milliseconds input indicators flash when being illuminated
@@ -19,20 +20,39 @@ extern "C" {
 #define ANIM_ANTS_INTERVAL 24 // Default animation frame interval for the `COLOR_ANTS` palette color, in milliseconds
 #define READ_DELAY 50 // For debouncing encoder reads
 #define INTERNAL_CLOCK_PERIOD 125 // Milliseconds between internal clock ticks
+#define SCHEDULER_PASS_BUDGET 1000 // Microseconds per scheduler pass that non-critical tasks may fill
+#define DISPLAY_REFRESH_BUDGET 400 // Microseconds per cycle that sending rows to the LED matrix may take
+#define EEPROM_SETTLE_TIME 1000 // Milliseconds that params must stay unchanged before they are written to EEPROM
+#define DISPLAY_YIELD_MARGIN 1 // Milliseconds before a clock tick or sequencer deadline that the LED matrix stops being sent rows
 
 /* FEATURES */
 
 #define INTERNAL_CLOCK_DEFAULT 0 // 0 = Internal clock begins disabled, 1 = begins enabled
 #define EEPROM_READ 1 // 0 = Reading from EEPROM disabled, 1 = enabled
 #define EEPROM_WRITE 1 // 0 = Writing to EEPROM disabled, 1 = enabled
+#define EEPROM_JOURNAL 0 // 0 = Params stored at the original fixed addresses, 1 = Params stored in a wear-leveled journal
 
 /* DEBUG FEATURES */
 
+#define TRIG_MONITOR 0 // 0 = Disabled, 1 = Count trig edges with an interrupt to detect missed triggers
+#define PERF_OVERLAY 0 // 0 = Disabled, 1 = Show cycle time, trig latency and missed deadlines on the CH SEL row instead
+#define PERF_OVERLAY_INTERVAL 250 // Milliseconds between redraws of the performance overlay
+#define SERIAL_REMOTE 0 // 0 = Disabled, 1 = Params can be read and written over serial with the binary protocol in remote.h. Shares the port with logging
+#define SERIAL_REMOTE_BYTES_PER_UPDATE 8 // Received bytes decoded per pass of the scheduler, at most
+#define SERIAL_BAUD 9600 // Baud rate of the serial port, for logging and remote control
+
 #define LOGGING_ENABLED 0 // 0 = Logging over serial disabled, 1 = enabled
 #define LOGGING_INPUT 0 // 0 = Don't log Input events, 1 = Log input events
-#define LOGGING_EEPROM 0 // 0 = Don't log EEPROM writes, 1 = Log EEPROM writes
-#define LOGGING_CYCLE_TIME 1 // 0 = Don't log max cycle time in the last interval, 1 = Do log max cycle time
-#define LOGGING_CYCLE_TIME_INTERVAL 1000 // Milliseconds to capture the max cycle time during
+#define LOGGING_EEPROM 0 // 0 = Don't log EEPROM writes, 1 = Log EEPROM writes, and writes suppressed every interval
+#define LOGGING_CYCLE_TIME 1 // 0 = Don't log cycle time in the last interval, 1 = Do log max and average cycle time
+#define LOGGING_CYCLE_TIME_INTERVAL 1000 // Milliseconds to capture the max and average cycle time during
+#define LOGGING_LED 0 // 0 = Don't log LED matrix, 1 = Log rows sent and skipped, frame latency and refresh time every interval
+#define LOGGING_REDRAW 0 // 0 = Don't log channel redraws, 1 = Log channels redrawn per second
+#define LOGGING_TRIG 0 // 0 = Don't log trig monitor, 1 = Log missed triggers, shortest pulse and max loop gap
+#define LOGGING_SCHEDULER 0 // 0 = Don't log scheduler, 1 = Log deadline misses of each task every interval, in task order
+#define LOGGING_STAGES 0 // 0 = Don't time loop stages, 1 = Keep a histogram of each loop stage's time, printed when "h" is received over serial. Not available with SERIAL_REMOTE
+#define LOGGING_TRIG_LATENCY 0 // 0 = Don't measure, 1 = Log min, median, p99 and max time from a trig edge to an output going high, and jitter (p99 - median), every interval. Edges are timestamped by the trig monitor if enabled, or else when polled
+#define LOGGING_BOOT 0 // 0 = Don't log boot, 1 = Log when each stage of booting finished, once the first frame is shown
 
 // clang-format on
 
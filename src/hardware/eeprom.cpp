@@ -1,42 +1,84 @@
 #include "eeprom.h"
 
+#include "hardware/eeprom_journal.h"
+#include "hardware/eeprom_queue.h"
 #include "logging.h"
 
-#if EEPROM_READ || EEPROM_WRITE
-#include <EEPROM.h>
-#endif
-
 void eeprom_params_load(Params *params, Mode mode) {
-	const uint8_t num_params = mode_num_params[mode];
+	const uint8_t num_params = mode_num_params(mode);
+
+	// Without a valid journal record, such as after upgrading, params are read
+	// from the fixed addresses that earlier firmware saved them to
+	const bool journal_loaded = eeprom_journal_load(params->values, num_params);
 
 	for (uint8_t idx = 0; idx < num_params; idx++) {
 #if EEPROM_READ
-		const Address addr = mode_param_address(mode, (ParamIdx)idx);
-		params->values[idx] = EEPROM.read(addr);
+		if (!journal_loaded) {
+			const Address addr = mode_param_address(mode, (ParamIdx)idx);
+			params->values[idx] = eeprom_queue_read(addr);
+		}
 #else
-		params.values[idx] = 0;
+		params->values[idx] = 0;
 #endif
-		params->flags[idx] = PARAM_FLAGS_NONE;
 	}
 
+	params_flags_clear_all(params, PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE);
 	params->len = num_params;
 }
 
-void eeprom_save_all_needing_write(Params *params, Mode mode) {
-#if EEPROM_WRITE
-	const uint8_t num_params = mode_num_params[mode];
-
-	for (uint8_t idx = 0; idx < num_params; idx++) {
-		const bool needs_write = param_flags_get(params, idx, PARAM_FLAG_NEEDS_WRITE);
-		if (!needs_write) continue;
+bool eeprom_save_all_needing_write(Params *params, Mode mode) {
+#if EEPROM_WRITE && EEPROM_JOURNAL
+	// Each record holds every param, so one record saves all of them
+	const Address record_addr = eeprom_journal_append(params->values, params->len);
+	if (!record_addr) return true;
 
-		param_flags_clear(params, idx, PARAM_FLAG_NEEDS_WRITE);
+	for (ParamBits pending = params->needs_write; pending; pending &= pending - 1) {
+		const ParamIdx idx = param_bits_first(pending);
+		log_eeprom_write(mode, idx, record_addr + idx, params->values[idx]);
+	}
+	params_flags_clear_all(params, PARAM_FLAG_NEEDS_WRITE);
+	return false;
+#elif EEPROM_WRITE
+	bool remaining = false;
+	for (ParamBits pending = params->needs_write; pending; pending &= pending - 1) {
+		const ParamIdx idx = param_bits_first(pending);
 
 		const uint8_t val = params->values[idx];
 		const Address addr = mode_param_address(mode, (ParamIdx)idx);
-		EEPROM.write(addr, val);
+		if (!eeprom_queue_write(addr, val)) {
+			remaining = true;
+			continue;
+		}
 
+		param_flags_clear(params, idx, PARAM_FLAG_NEEDS_WRITE);
 		log_eeprom_write(mode, idx, addr, val);
 	}
+
+	return remaining;
+#else
+	return false;
 #endif
-}
\ No newline at end of file
+}
+
+void eeprom_block_read(uint8_t *values, Address addr, uint8_t len) {
+	for (uint8_t idx = 0; idx < len; idx++) {
+#if EEPROM_READ
+		values[idx] = eeprom_queue_read(addr + idx);
+#else
+		values[idx] = 0;
+#endif
+	}
+}
+
+bool eeprom_block_write(const uint8_t *values, Address addr, uint8_t len) {
+#if EEPROM_WRITE
+	// Early return: Queue the whole block or none of it, so that a block is
+	// never left half-written
+	if (eeprom_queue_free() < len) return false;
+
+	for (uint8_t idx = 0; idx < len; idx++) {
+		eeprom_queue_write(addr + idx, values[idx]);
+	}
+#endif
+	return true;
+}
@@ -10,7 +10,20 @@ extern "C" {
 
 /// Load state for the given mode into `params`.
 void eeprom_params_load(Params *params, Mode mode);
-void eeprom_save_all_needing_write(Params *params, Mode mode);
+/// Queue every param flagged with `PARAM_FLAG_NEEDS_WRITE` to be written to
+/// EEPROM, clearing the flag of each one that was queued.
+/// @return `true` if some params couldn't be queued because the queue is full,
+/// and still need to be written.
+bool eeprom_save_all_needing_write(Params *params, Mode mode);
+
+/// Read `len` consecutive bytes, starting at `addr`, into `values`.
+void eeprom_block_read(uint8_t *values, Address addr, uint8_t len);
+/// Queue `len` consecutive bytes from `values` to be written, starting at
+/// `addr`. Bytes that already hold the same value are not rewritten. Never
+/// waits on the EEPROM.
+/// @return `false` if the write queue doesn't have room for the whole block, in
+/// which case nothing is queued and the write should be retried later.
+bool eeprom_block_write(const uint8_t *values, Address addr, uint8_t len);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,153 @@
+#include "eeprom_journal.h"
+
+#include "hardware/eeprom_queue.h"
+
+#include <avr/io.h>
+#include <string.h>
+#include <util/crc16.h>
+
+#if EEPROM_JOURNAL
+
+/* CONSTANTS */
+
+/// First address of the journal, right after the presets
+#define JOURNAL_ADDRESS 160
+/// A record is a 16-bit sequence number, the param values, then a CRC-8 of
+/// everything before it
+#define RECORD_SEQ_OFFSET 0
+#define RECORD_VALUES_OFFSET 2
+#define RECORD_CRC_OFFSET (RECORD_VALUES_OFFSET + PARAMS_MAX)
+#define RECORD_LEN (RECORD_CRC_OFFSET + 1)
+#define JOURNAL_SLOTS ((E2END + 1 - JOURNAL_ADDRESS) / RECORD_LEN)
+
+/// Sequence number of an erased slot
+#define SEQ_ERASED 0xFFFF
+
+/* GLOBALS */
+
+/// Slot and sequence number for the next record to be appended
+static uint8_t next_slot = 0;
+static uint16_t next_seq = 0;
+
+/* DECLARATIONS */
+
+static inline Address slot_address(uint8_t slot);
+/// The sequence number after `seq`, skipping the one that erased slots have
+static inline uint16_t seq_following(uint16_t seq);
+static uint16_t record_seq_read(uint8_t slot);
+/// Read the record in `slot` into `record`
+/// @return `true` if the record's CRC is valid
+static bool record_read(uint8_t slot, uint8_t *record);
+static uint8_t record_crc(const uint8_t *record);
+
+#endif
+
+/* EXTERNAL */
+
+// cppcheck-suppress unusedFunction
+bool eeprom_journal_load(uint8_t *values, uint8_t len) {
+#if EEPROM_JOURNAL && EEPROM_READ
+	// Records are appended in order, so the newest record is the one with the
+	// latest sequence number. Only the sequence numbers are read to find it.
+	bool any = false;
+	uint16_t newest_seq = 0;
+	uint8_t newest_slot = 0;
+	for (uint8_t slot = 0; slot < JOURNAL_SLOTS; slot++) {
+		const uint16_t seq = record_seq_read(slot);
+		if (seq == SEQ_ERASED) continue;
+
+		if (!any || (int16_t)(seq - newest_seq) > 0) {
+			newest_seq = seq;
+			newest_slot = slot;
+			any = true;
+		}
+	}
+
+	// Early return: Nothing to load, and the journal starts from its first slot
+	if (!any) {
+		next_slot = 0;
+		next_seq = 0;
+		return false;
+	}
+	next_slot = (newest_slot + 1) % JOURNAL_SLOTS;
+	next_seq = seq_following(newest_seq);
+
+	// If the newest record was only partly written, such as when the power was
+	// cut, step back through older records until one is valid
+	uint8_t record[RECORD_LEN];
+	uint8_t slot = newest_slot;
+	for (uint8_t i = 0; i < JOURNAL_SLOTS; i++) {
+		if (record_read(slot, record)) {
+			memcpy(values, &record[RECORD_VALUES_OFFSET], len);
+			return true;
+		}
+		slot = (slot + JOURNAL_SLOTS - 1) % JOURNAL_SLOTS;
+	}
+#endif
+	return false;
+}
+
+// cppcheck-suppress unusedFunction
+Address eeprom_journal_append(const uint8_t *values, uint8_t len) {
+#if EEPROM_JOURNAL && EEPROM_WRITE
+	if (eeprom_queue_free() < RECORD_LEN) return 0;
+
+	uint8_t record[RECORD_LEN] = {0};
+	record[RECORD_SEQ_OFFSET] = next_seq & 0xFF;
+	record[RECORD_SEQ_OFFSET + 1] = next_seq >> 8;
+	memcpy(&record[RECORD_VALUES_OFFSET], values, len);
+	record[RECORD_CRC_OFFSET] = record_crc(record);
+
+	// The CRC is queued last, so a record is only valid once it has been
+	// completely written
+	const Address addr = slot_address(next_slot);
+	for (uint8_t i = 0; i < RECORD_LEN; i++) {
+		eeprom_queue_write(addr + i, record[i]);
+	}
+
+	next_slot = (next_slot + 1) % JOURNAL_SLOTS;
+	next_seq = seq_following(next_seq);
+
+	return addr + RECORD_VALUES_OFFSET;
+#else
+	return 0;
+#endif
+}
+
+/* INTERNAL */
+
+#if EEPROM_JOURNAL
+
+static inline Address slot_address(uint8_t slot) {
+	return JOURNAL_ADDRESS + ((Address)slot * RECORD_LEN);
+}
+
+static inline uint16_t seq_following(uint16_t seq) {
+	seq++;
+	return (seq == SEQ_ERASED) ? 0 : seq;
+}
+
+static uint16_t record_seq_read(uint8_t slot) {
+	const Address addr = slot_address(slot) + RECORD_SEQ_OFFSET;
+	return eeprom_queue_read(addr) | ((uint16_t)eeprom_queue_read(addr + 1) << 8);
+}
+
+static bool record_read(uint8_t slot, uint8_t *record) {
+	if (record_seq_read(slot) == SEQ_ERASED) return false;
+
+	const Address addr = slot_address(slot);
+	for (uint8_t i = 0; i < RECORD_LEN; i++) {
+		record[i] = eeprom_queue_read(addr + i);
+	}
+	return record_crc(record) == record[RECORD_CRC_OFFSET];
+}
+
+static uint8_t record_crc(const uint8_t *record) {
+	uint8_t crc = 0;
+	for (uint8_t i = 0; i < RECORD_CRC_OFFSET; i++) {
+		crc = _crc8_ccitt_update(crc, record[i]);
+	}
+	return crc;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef EEPROM_JOURNAL_H_
+#define EEPROM_JOURNAL_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/params.h"
+#include "common/types.h"
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The journal stores params as a log of records spread across the EEPROM
+ * after the presets, instead of at fixed addresses, so that no cell takes
+ * every write. Each record holds every param value, a sequence number and a
+ * CRC, and the newest record with a valid CRC is the one that is loaded. Only
+ * active when `EEPROM_JOURNAL` is enabled.
+ */
+
+/// Load the param values of the newest valid record into `values`.
+/// @param len Number of param values, at most `PARAMS_MAX`
+/// @return `false` if the journal has no valid record, such as when upgrading
+/// from firmware that stored params at fixed addresses.
+bool eeprom_journal_load(uint8_t *values, uint8_t len);
+
+/// Queue a new record holding `values`, after the newest record.
+/// @param len Number of param values, at most `PARAMS_MAX`
+/// @return Address of the first param value in the new record, or `0` if the
+/// EEPROM write queue doesn't have room for a record.
+Address eeprom_journal_append(const uint8_t *values, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EEPROM_JOURNAL_H_ */
@@ -0,0 +1,164 @@
+#include "eeprom_queue.h"
+
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+/* DATA STRUCTURES */
+
+typedef struct EepromWrite {
+	uint16_t addr;
+	uint8_t value;
+} EepromWrite;
+
+/* GLOBALS */
+
+#if EEPROM_WRITE
+
+/// Ring buffer of pending writes. Shared with the EEPROM ready interrupt, so
+/// must be accessed atomically.
+static volatile EepromWrite queue[EEPROM_QUEUE_LEN];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_count = 0;
+/// Writes skipped because the EEPROM already held the value
+static volatile uint16_t unchanged_count = 0;
+
+/* DECLARATIONS */
+
+/// Index of the queued write to `addr`, or `EEPROM_QUEUE_LEN` if there isn't
+/// one. Must be called atomically.
+static uint8_t queue_find(uint16_t addr);
+
+/* INTERRUPTS */
+
+// Fires whenever the EEPROM is ready for another write, for as long as it is
+// enabled, so each run starts programming the next byte that differs
+ISR(EE_READY_vect) {
+	while (queue_count) {
+		const EepromWrite write = queue[queue_head];
+		queue_head = (queue_head + 1) % EEPROM_QUEUE_LEN;
+		queue_count--;
+
+		EEAR = write.addr;
+		EECR |= _BV(EERE);
+		if (EEDR == write.value) {
+			unchanged_count++;
+			continue;
+		}
+
+		// EEPE must be set within four cycles of EEMPE, which holds here because
+		// interrupts are disabled inside an ISR
+		EEDR = write.value;
+		EECR |= _BV(EEMPE);
+		EECR |= _BV(EEPE);
+		return;
+	}
+
+	// Nothing left to write
+	EECR &= ~_BV(EERIE);
+}
+
+#endif
+
+/* EXTERNAL */
+
+// cppcheck-suppress unusedFunction
+bool eeprom_queue_write(Address addr, uint8_t value) {
+#if EEPROM_WRITE
+	bool queued = false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		uint8_t idx = queue_find(addr);
+		if (idx == EEPROM_QUEUE_LEN && queue_count < EEPROM_QUEUE_LEN) {
+			idx = (queue_head + queue_count) % EEPROM_QUEUE_LEN;
+			queue[idx].addr = addr;
+			queue_count++;
+		}
+		if (idx != EEPROM_QUEUE_LEN) {
+			queue[idx].value = value;
+			queued = true;
+		}
+
+		EECR |= _BV(EERIE);
+	}
+	return queued;
+#else
+	return true;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t eeprom_queue_read(Address addr) {
+#if EEPROM_WRITE
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		const uint8_t idx = queue_find(addr);
+		if (idx != EEPROM_QUEUE_LEN) {
+			return queue[idx].value;
+		}
+
+		// Keep the interrupt off the EEPROM registers while they are used for the
+		// read. The read itself waits for any byte being programmed, so it runs
+		// with interrupts enabled.
+		EECR &= ~_BV(EERIE);
+	}
+
+	const uint8_t value = eeprom_read_byte((const uint8_t *)(uintptr_t)addr);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (queue_count) {
+			EECR |= _BV(EERIE);
+		}
+	}
+	return value;
+#else
+	return eeprom_read_byte((const uint8_t *)(uintptr_t)addr);
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t eeprom_queue_free(void) {
+#if EEPROM_WRITE
+	uint8_t result;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { result = EEPROM_QUEUE_LEN - queue_count; }
+	return result;
+#else
+	return EEPROM_QUEUE_LEN;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t eeprom_queue_unchanged_take(void) {
+#if EEPROM_WRITE
+	uint16_t result;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		result = unchanged_count;
+		unchanged_count = 0;
+	}
+	return result;
+#else
+	return 0;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void eeprom_queue_flush(void) {
+#if EEPROM_WRITE
+	while (queue_count) {
+	}
+	eeprom_busy_wait();
+#endif
+}
+
+/* INTERNAL */
+
+#if EEPROM_WRITE
+
+static uint8_t queue_find(uint16_t addr) {
+	for (uint8_t i = 0; i < queue_count; i++) {
+		const uint8_t idx = (queue_head + i) % EEPROM_QUEUE_LEN;
+		if (queue[idx].addr == addr) return idx;
+	}
+	return EEPROM_QUEUE_LEN;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef EEPROM_QUEUE_H_
+#define EEPROM_QUEUE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/types.h"
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Writes to EEPROM are queued and programmed one byte at a time from the
+ * EEPROM ready interrupt, so the main loop never waits for a byte to finish
+ * programming. Queueing a write to an address that is already queued replaces
+ * the queued value. Bytes which already hold the queued value are skipped.
+ * Only active when `EEPROM_WRITE` is enabled.
+ */
+
+/// Number of writes that can be queued at once
+#define EEPROM_QUEUE_LEN 16
+
+/// Queue `value` to be written to `addr`.
+/// @return `false` if the queue is full and the write was not queued.
+bool eeprom_queue_write(Address addr, uint8_t value);
+
+/// Read the byte at `addr`, including any write to it that is still queued.
+uint8_t eeprom_queue_read(Address addr);
+
+/// Number of writes that can still be queued
+uint8_t eeprom_queue_free(void);
+
+/// Number of queued writes that were skipped because the EEPROM already held
+/// the value, since this was last called.
+uint16_t eeprom_queue_unchanged_take(void);
+
+/// Wait until every queued write has been programmed, such as before
+/// shutting down.
+void eeprom_queue_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EEPROM_QUEUE_H_ */
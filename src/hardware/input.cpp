@@ -2,7 +2,9 @@
 
 #include "common/timeout.h"
 #include "config.h"
+#include "hardware/pin_io.h"
 #include "hardware/pins.h"
+#include "hardware/trig_monitor.h"
 
 #include <Arduino.h>
 #include <Encoder.h>
@@ -16,6 +18,7 @@
 static bool reset_active = false;
 
 static int trig_in_value_previous = 0;
+static Microseconds trig_time = 0;
 
 static bool encoder_pushed = false;
 
@@ -58,15 +61,15 @@ static int encoder_read(Encoder &enc);
 
 // cppcheck-suppress unusedFunction
 void input_init(void) {
-	pinMode(PIN_IN_TRIG, INPUT);
+	pin_mode_input(PIN_IN_TRIG);
 
 	// Turn on pull-up resistors for encoders
-	digitalWrite(PIN_ENC_1A, HIGH);
-	digitalWrite(PIN_ENC_1B, HIGH);
-	digitalWrite(PIN_ENC_2A, HIGH);
-	digitalWrite(PIN_ENC_2B, HIGH);
-	digitalWrite(PIN_ENC_3A, HIGH);
-	digitalWrite(PIN_ENC_3B, HIGH);
+	pin_set_high(PIN_ENC_1A);
+	pin_set_high(PIN_ENC_1B);
+	pin_set_high(PIN_ENC_2A);
+	pin_set_high(PIN_ENC_2B);
+	pin_set_high(PIN_ENC_3A);
+	pin_set_high(PIN_ENC_3B);
 }
 
 // cppcheck-suppress unusedFunction
@@ -76,8 +79,12 @@ void input_update(InputEvents *events, Milliseconds now) {
 	events->reset = detect_rise_reset(reset_in_value);
 
 	// Trig Input
-	const int trig_in_value = digitalRead(PIN_IN_TRIG);
+	const int trig_in_value = pin_read(PIN_IN_TRIG);
+	trig_monitor_record_poll();
 	events->trig = detect_rise_trig(trig_in_value);
+	if (events->trig) {
+		trig_time = micros();
+	}
 
 	// Encoder Movement
 	bool move_detected = false;
@@ -97,6 +104,16 @@ void input_update(InputEvents *events, Milliseconds now) {
 	events->enc_push = detect_enc_push(channel_switch_val);
 }
 
+// cppcheck-suppress unusedFunction
+bool input_trig_pending(void) {
+	return pin_read(PIN_IN_TRIG) > trig_in_value_previous;
+}
+
+// cppcheck-suppress unusedFunction
+Microseconds input_trig_time(void) {
+	return trig_time;
+}
+
 /* INTERNAL */
 
 static bool detect_rise_reset(int reset_in_value) {
@@ -12,6 +12,14 @@ void input_init(void);
 /// Populates the passed-in struct with events observed since last cycle.
 void input_update(InputEvents *events, Milliseconds now);
 
+/// Has the trig input risen since it was last read by `input_update()`? Cheap
+/// enough to check in between other work.
+bool input_trig_pending(void);
+
+/// When `input_update()` last read a rising edge on the trig input, in
+/// microseconds.
+Microseconds input_trig_time(void);
+
 #ifdef __cplusplus
 }
 #endif
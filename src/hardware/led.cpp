@@ -1,37 +1,35 @@
 #include "led.h"
 
 #include "config.h"
-#include "hardware/pins.h"
-
-#include <LedControl.h>
-
-// Initialize objects for controlling LED matrix
-// (from LedControl.h library)
-// 1 is maximum number of devices that can be controlled
-static LedControl lc = LedControl(PIN_OUT_LED_DATA, PIN_OUT_LED_CLOCK, PIN_OUT_LED_SELECT, 1);
+#include "hardware/max7219.h"
+#include "hardware/properties.h"
 
 /* EXTERNAL */
 
 // cppcheck-suppress unusedFunction
 void led_init(void) {
+	max7219_init();
+
 	// The LED matrix is in power-saving mode on startup.
 	// Set power-saving mode to false to wake it up
-	lc.shutdown(LED_ADDR, false);
-	lc.setIntensity(LED_ADDR, LED_BRIGHTNESS);
-	lc.clearDisplay(LED_ADDR);
+	max7219_shutdown(false);
+	max7219_set_intensity(LED_BRIGHTNESS);
+	for (uint8_t row = 0; row < LED_ROWS; row++) {
+		max7219_set_row(row, 0);
+	}
 }
 
 // cppcheck-suppress unusedFunction
-void led_set_row(uint8_t row, uint8_t pixels) { lc.setRow(LED_ADDR, row, pixels); }
+void led_set_row(uint8_t row, uint8_t pixels) { max7219_set_row(row, pixels); }
 
 // cppcheck-suppress unusedFunction
-void led_sleep() { lc.shutdown(LED_ADDR, true); }
+void led_sleep() { max7219_shutdown(true); }
 
 // cppcheck-suppress unusedFunction
-void led_dim() { lc.setIntensity(LED_ADDR, LED_BRIGHTNESS_DIM); }
+void led_dim() { max7219_set_intensity(LED_BRIGHTNESS_DIM); }
 
 // cppcheck-suppress unusedFunction
 void led_wake() {
-	lc.shutdown(LED_ADDR, false);
-	lc.setIntensity(LED_ADDR, LED_BRIGHTNESS);
+	max7219_shutdown(false);
+	max7219_set_intensity(LED_BRIGHTNESS);
 }
@@ -0,0 +1,66 @@
+#include "max7219.h"
+
+#include "hardware/pin_io.h"
+#include "hardware/pins.h"
+
+/* CONSTANTS */
+
+// Register addresses
+#define MAX7219_REG_DIGIT_0 0x01
+#define MAX7219_REG_DECODE_MODE 0x09
+#define MAX7219_REG_INTENSITY 0x0A
+#define MAX7219_REG_SCAN_LIMIT 0x0B
+#define MAX7219_REG_SHUTDOWN 0x0C
+#define MAX7219_REG_DISPLAY_TEST 0x0F
+
+/* DECLARATIONS */
+
+/// Send a 16-bit command to the chip, which is latched when the select pin rises
+static void max7219_write(uint8_t reg, uint8_t data);
+/// Shift out a byte, most significant bit first. The chip samples its data
+/// input on the rising edge of the clock.
+static inline void max7219_shift_out(uint8_t byte);
+
+/* EXTERNAL */
+
+// cppcheck-suppress unusedFunction
+void max7219_init(void) {
+	pin_set_high(PIN_OUT_LED_SELECT);
+	pin_set_low(PIN_OUT_LED_CLOCK);
+	pin_mode_output(PIN_OUT_LED_DATA);
+	pin_mode_output(PIN_OUT_LED_CLOCK);
+	pin_mode_output(PIN_OUT_LED_SELECT);
+
+	max7219_write(MAX7219_REG_DISPLAY_TEST, 0);
+	// Scan all 8 rows
+	max7219_write(MAX7219_REG_SCAN_LIMIT, 7);
+	// Rows are raw pixels, not BCD digits
+	max7219_write(MAX7219_REG_DECODE_MODE, 0);
+	max7219_shutdown(true);
+}
+
+// cppcheck-suppress unusedFunction
+void max7219_set_row(uint8_t row, uint8_t pixels) { max7219_write(MAX7219_REG_DIGIT_0 + row, pixels); }
+
+// cppcheck-suppress unusedFunction
+void max7219_set_intensity(uint8_t intensity) { max7219_write(MAX7219_REG_INTENSITY, intensity); }
+
+// cppcheck-suppress unusedFunction
+void max7219_shutdown(bool shutdown) { max7219_write(MAX7219_REG_SHUTDOWN, (shutdown) ? 0 : 1); }
+
+/* INTERNAL */
+
+static void max7219_write(uint8_t reg, uint8_t data) {
+	pin_set_low(PIN_OUT_LED_SELECT);
+	max7219_shift_out(reg);
+	max7219_shift_out(data);
+	pin_set_high(PIN_OUT_LED_SELECT);
+}
+
+static inline void max7219_shift_out(uint8_t byte) {
+	for (uint8_t mask = 0x80; mask; mask >>= 1) {
+		pin_write(PIN_OUT_LED_DATA, byte & mask);
+		pin_set_high(PIN_OUT_LED_CLOCK);
+		pin_set_low(PIN_OUT_LED_CLOCK);
+	}
+}
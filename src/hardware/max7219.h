@@ -0,0 +1,33 @@
+#ifndef MAX7219_H_
+#define MAX7219_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Driver for a single MAX7219 LED matrix driver, bit-banged over the
+ * `PIN_OUT_LED_*` pins with direct port access. It keeps no copy of what is
+ * displayed - the framebuffer is the only copy.
+ */
+
+/// Configure the pins and the chip's registers for driving an 8x8 LED matrix.
+/// The chip is left in shutdown mode, as it is on power-up.
+void max7219_init(void);
+
+/// Set the pixels of a row of the LED matrix
+/// @param row Zero-indexed row, from 0 to 7
+/// @param pixels One bit per pixel
+void max7219_set_row(uint8_t row, uint8_t pixels);
+
+/// @param intensity From 0 (low) to 15
+void max7219_set_intensity(uint8_t intensity);
+
+/// Enter or leave shutdown mode, which blanks the display but retains its contents
+void max7219_shutdown(bool shutdown);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MAX7219_H_ */
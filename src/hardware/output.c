@@ -1,48 +1,46 @@
 #include "output.h"
 
+#include "hardware/pin_io.h"
 #include "hardware/pins.h"
-
-#include <Arduino.h>
-
-/* DECLARATIONS */
-
-static inline uint8_t output_pin_from_channel(OutputChannel channel);
+#include "logging.h"
 
 /* EXTERNAL */
 
 // cppcheck-suppress unusedFunction
 void output_init(void) {
-	pinMode(PIN_OUT_CHANNEL_1, OUTPUT);
-	pinMode(PIN_OUT_CHANNEL_2, OUTPUT);
-	pinMode(PIN_OUT_CHANNEL_3, OUTPUT);
-	pinMode(PIN_OUT_OFFBEAT, OUTPUT);
+	pin_mode_output(PIN_OUT_CHANNEL_1);
+	pin_mode_output(PIN_OUT_CHANNEL_2);
+	pin_mode_output(PIN_OUT_CHANNEL_3);
+	pin_mode_output(PIN_OUT_OFFBEAT);
 }
 
 // cppcheck-suppress unusedFunction
 void output_set(OutputChannel channel, bool value) {
-	const uint8_t pin = output_pin_from_channel(channel);
-	digitalWrite(pin, (value) ? HIGH : LOW); // pulse out
-}
-
-// cppcheck-suppress unusedFunction
-void output_clear_all(void) {
-	output_set_low(OUTPUT_CHANNEL_1);
-	output_set_low(OUTPUT_CHANNEL_2);
-	output_set_low(OUTPUT_CHANNEL_3);
-	output_set_low(OUTPUT_CHANNEL_OFFBEAT);
-}
-
-/* INTERNAL*/
-
-static inline uint8_t output_pin_from_channel(OutputChannel channel) {
+	// Each case writes a constant pin, so it compiles to a single instruction
 	switch (channel) {
 		case OUTPUT_CHANNEL_1:
-			return PIN_OUT_CHANNEL_1;
+			pin_write(PIN_OUT_CHANNEL_1, value);
+			break;
 		case OUTPUT_CHANNEL_2:
-			return PIN_OUT_CHANNEL_2;
+			pin_write(PIN_OUT_CHANNEL_2, value);
+			break;
 		case OUTPUT_CHANNEL_3:
-			return PIN_OUT_CHANNEL_3;
+			pin_write(PIN_OUT_CHANNEL_3, value);
+			break;
 		default:
-			return PIN_OUT_OFFBEAT;
+			pin_write(PIN_OUT_OFFBEAT, value);
+			break;
+	}
+
+	if (value) {
+		log_output_high();
 	}
-}
\ No newline at end of file
+}
+
+// cppcheck-suppress unusedFunction
+void output_clear_all(void) {
+	pin_set_low(PIN_OUT_CHANNEL_1);
+	pin_set_low(PIN_OUT_CHANNEL_2);
+	pin_set_low(PIN_OUT_CHANNEL_3);
+	pin_set_low(PIN_OUT_OFFBEAT);
+}
@@ -0,0 +1,43 @@
+#ifndef PIN_IO_H_
+#define PIN_IO_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <avr/io.h>
+
+/* Direct port access for the `PIN_*` definitions in `pins.h`, bypassing the
+ * Arduino runtime's pin lookup tables. When `pin` is a compile-time constant,
+ * each macro resolves to a single `sbi`, `cbi`, `sbis` or `sbic` instruction.
+ *
+ * Pin numbers follow the Arduino Nano (ATmega328P) numbering: digital pins 0-7
+ * are on port D, 8-13 are on port B, and 14-19 (A0-A5) are on port C.
+ */
+
+#define PIN_IO_PORT(pin) (((pin) < 8) ? &PORTD : (((pin) < 14) ? &PORTB : &PORTC))
+#define PIN_IO_DDR(pin) (((pin) < 8) ? &DDRD : (((pin) < 14) ? &DDRB : &DDRC))
+#define PIN_IO_PIN(pin) (((pin) < 8) ? &PIND : (((pin) < 14) ? &PINB : &PINC))
+#define PIN_IO_BIT(pin) (((pin) < 8) ? (pin) : (((pin) < 14) ? ((pin)-8) : ((pin)-14)))
+#define PIN_IO_MASK(pin) ((uint8_t)(1 << PIN_IO_BIT(pin)))
+
+/// Configure `pin` as an output
+#define pin_mode_output(pin) (*PIN_IO_DDR(pin) |= PIN_IO_MASK(pin))
+/// Configure `pin` as an input. Use `pin_set_high()` afterwards to enable its pull-up resistor.
+#define pin_mode_input(pin) (*PIN_IO_DDR(pin) &= (uint8_t)~PIN_IO_MASK(pin))
+#define pin_set_high(pin) (*PIN_IO_PORT(pin) |= PIN_IO_MASK(pin))
+#define pin_set_low(pin) (*PIN_IO_PORT(pin) &= (uint8_t)~PIN_IO_MASK(pin))
+#define pin_write(pin, value)                                                                                \
+	do {                                                                                                     \
+		if (value) {                                                                                         \
+			pin_set_high(pin);                                                                               \
+		} else {                                                                                             \
+			pin_set_low(pin);                                                                                \
+		}                                                                                                    \
+	} while (0)
+/// Evaluates to `true` if `pin` reads high
+#define pin_read(pin) ((*PIN_IO_PIN(pin) & PIN_IO_MASK(pin)) != 0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PIN_IO_H_ */
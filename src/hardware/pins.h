@@ -28,9 +28,6 @@ extern "C" {
 #define PIN_ENC_3A 6
 #define PIN_ENC_3B 5
 
-// LED Matrix address
-#define LED_ADDR 0
-
 #ifdef __cplusplus
 }
 #endif
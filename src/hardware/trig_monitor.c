@@ -0,0 +1,124 @@
+#include "trig_monitor.h"
+
+#include "hardware/pin_io.h"
+#include "hardware/pins.h"
+
+#include <Arduino.h>
+#include <util/atomic.h>
+
+#if TRIG_MONITOR
+
+/* GLOBALS */
+
+/// Written from the pin change interrupt, so must be read atomically
+static volatile TrigMonitorStats stats_live;
+/// When the trig input last went high, in microseconds
+static volatile Microseconds rise_time;
+static volatile bool rise_seen = false;
+/// Level of the trig input when the interrupt last read it
+static volatile bool trig_high;
+
+static Microseconds last_poll_time;
+
+/* INTERRUPTS */
+
+// The trig input, A0, is PC0, which is covered by PCINT1. Every pin change is
+// an edge, but the pin is only read once the interrupt has been entered, so a
+// pulse that is shorter than that may already have ended. Reading the same
+// level as last time means that a whole pulse was missed in between.
+ISR(PCINT1_vect) {
+	const Microseconds now_us = micros();
+	const bool high = pin_read(PIN_IN_TRIG);
+
+	// A rise, possibly one whose fall has already happened too
+	if (high || !trig_high) {
+		stats_live.edges_seen++;
+		rise_time = now_us;
+		rise_seen = true;
+	}
+
+	// A fall. If the rise was only seen by this interrupt, the pulse was too short
+	// to be timed.
+	if (!high && rise_seen) {
+		const Microseconds width = (trig_high) ? now_us - rise_time : 0;
+		if (width < stats_live.pulse_width_min) {
+			stats_live.pulse_width_min = width;
+		}
+	}
+
+	trig_high = high;
+}
+
+#endif
+
+/* EXTERNAL */
+
+// cppcheck-suppress unusedFunction
+void trig_monitor_init(void) {
+#if TRIG_MONITOR
+	trig_monitor_reset_extremes();
+	last_poll_time = micros();
+	trig_high = pin_read(PIN_IN_TRIG);
+
+	// Enable the pin change interrupt for the trig input only
+	PCMSK1 |= _BV(PCINT8);
+	PCICR |= _BV(PCIE1);
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void trig_monitor_record_poll(void) {
+#if TRIG_MONITOR
+	const Microseconds now_us = micros();
+	const Microseconds gap = now_us - last_poll_time;
+	last_poll_time = now_us;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (gap > stats_live.poll_gap_max) {
+			stats_live.poll_gap_max = gap;
+		}
+	}
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void trig_monitor_record_consumed(void) {
+#if TRIG_MONITOR
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { stats_live.edges_consumed++; }
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void trig_monitor_stats(TrigMonitorStats *stats) {
+#if TRIG_MONITOR
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		stats->edges_seen = stats_live.edges_seen;
+		stats->edges_consumed = stats_live.edges_consumed;
+		stats->pulse_width_min = stats_live.pulse_width_min;
+		stats->poll_gap_max = stats_live.poll_gap_max;
+	}
+#else
+	*stats = (TrigMonitorStats){0};
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+Microseconds trig_monitor_rise_time(void) {
+#if TRIG_MONITOR
+	Microseconds result;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { result = rise_time; }
+	return result;
+#else
+	return 0;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void trig_monitor_reset_extremes(void) {
+#if TRIG_MONITOR
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		stats_live.pulse_width_min = UINT32_MAX;
+		stats_live.poll_gap_max = 0;
+	}
+#endif
+}
@@ -0,0 +1,55 @@
+#ifndef TRIG_MONITOR_H_
+#define TRIG_MONITOR_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/types.h"
+#include "config.h"
+
+#include <stdint.h>
+
+/* The trig monitor counts rising edges on the trig input with a pin change
+ * interrupt, independently of the polling in `input_update()`. Comparing that
+ * count to the number of edges that the sequencer actually received shows how
+ * many triggers were missed. Only active when `TRIG_MONITOR` is enabled.
+ *
+ * Pulses of any width are counted, but the interrupt only reads the pin a few
+ * microseconds after each change. A pulse that has already ended by then is
+ * counted with a width of 0, so widths below that are not measured.
+ */
+
+typedef struct TrigMonitorStats {
+	/// Rising edges detected by the pin change interrupt
+	uint32_t edges_seen;
+	/// Rising edges that reached the sequencer as trig events
+	uint32_t edges_consumed;
+	/// Shortest high pulse measured on the trig input, in microseconds. `0` if a
+	/// pulse was too short for the interrupt to time.
+	Microseconds pulse_width_min;
+	/// Longest time between two polls of the trig input, in microseconds
+	Microseconds poll_gap_max;
+} TrigMonitorStats;
+
+void trig_monitor_init(void);
+
+/// Note that the trig input has just been polled
+void trig_monitor_record_poll(void);
+
+/// Note that a trig event has been handled by the sequencer
+void trig_monitor_record_consumed(void);
+
+/// When the trig input last went high, in microseconds, as timestamped by the
+/// pin change interrupt. Always `0` if the trig monitor is disabled.
+Microseconds trig_monitor_rise_time(void);
+
+/// Copy the current statistics into `stats`
+void trig_monitor_stats(TrigMonitorStats *stats);
+
+/// Restart measuring the shortest pulse width and longest poll gap
+void trig_monitor_reset_extremes(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRIG_MONITOR_H_ */
@@ -1,78 +1,282 @@
 #include "logging.h"
 
+#include "common/math.h"
 #include "common/timeout.h"
+#include "hardware/eeprom_queue.h"
+#include "hardware/input.h"
+#include "hardware/trig_monitor.h"
 
 #include <Arduino.h>
 
 /* GLOBALS */
 
-#if LOGGING_ENABLED && LOGGING_CYCLE_TIME
+#define CYCLE_TIME_MEASURED ((LOGGING_ENABLED && LOGGING_CYCLE_TIME) || PERF_OVERLAY)
+
+#if CYCLE_TIME_MEASURED
 static Microseconds cycle_time_start;
+static Microseconds cycle_time_recent_max;
+#endif
+
+#if LOGGING_ENABLED && LOGGING_CYCLE_TIME
 static Microseconds cycle_time_max;
+static Microseconds cycle_time_total;
+static uint32_t cycle_count;
 static Timeout log_cycle_time_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
 #endif
 
+#if LOGGING_ENABLED && LOGGING_EEPROM
+static Timeout log_suppressed_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
+static uint16_t param_writes_suppressed;
+#endif
+
+#if LOGGING_ENABLED && LOGGING_SCHEDULER
+static Timeout log_scheduler_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
+#endif
+
+#if LOGGING_ENABLED && LOGGING_TRIG && TRIG_MONITOR
+static Timeout log_trig_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
+#endif
+
+#if LOGGING_ENABLED && LOGGING_TRIG_LATENCY
+/// Latencies are counted in buckets of this many microseconds. The last bucket
+/// also counts every longer latency.
+#define TRIG_LATENCY_BUCKET_WIDTH 32
+#define TRIG_LATENCY_BUCKETS 64
+
+static Timeout log_trig_latency_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
+/// When an output first went high during the current sequencer update
+static Microseconds output_high_time;
+static bool output_high_recorded;
+/// Number of latencies in each bucket. All of them are halved when one is about
+/// to overflow, so that older latencies count for less.
+static uint16_t trig_latency_histogram[TRIG_LATENCY_BUCKETS];
+static uint32_t trig_latency_count;
+static Microseconds trig_latency_min = UINT32_MAX;
+static Microseconds trig_latency_max;
+#endif
+
+#if LOGGING_ENABLED && LOGGING_LED
+static Timeout log_led_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
+static uint16_t led_rows_sent;
+static uint16_t led_rows_skipped;
+static Microseconds led_frame_start;
+static Microseconds led_frame_latency_max;
+static Microseconds led_refresh_time_max;
+#endif
+
+#if LOGGING_ENABLED && LOGGING_REDRAW
+static Timeout log_redraw_timeout = {.duration = LOGGING_CYCLE_TIME_INTERVAL};
+static uint16_t channel_redraws;
+#endif
+
+#if LOGGING_ENABLED && LOGGING_STAGES
+#if SERIAL_REMOTE
+#error "LOGGING_STAGES reads requests from serial, which SERIAL_REMOTE uses"
+#endif
+
+/// Histogram buckets are powers of two. Bucket `n` counts times with a bit
+/// length of `n`, so bucket 0 is 0us, bucket 1 is 1us, bucket 2 is 2-3us, and
+/// so on. The last bucket also counts every longer time.
+#define STAGE_HISTOGRAM_BUCKETS 12
+/// Byte which requests the histograms to be printed
+#define STAGE_HISTOGRAMS_REQUEST 'h'
+
+static Microseconds loop_stage_start;
+/// Indexed by `LoopStage`, then by bucket. Counts saturate instead of
+/// overflowing.
+static uint16_t loop_stage_histograms[LOOP_STAGES_NUM][STAGE_HISTOGRAM_BUCKETS];
+static const char loop_stage_names[LOOP_STAGES_NUM][12] PROGMEM = {
+    "Input", "Clock", "Mode Update", "Indicators", "Animations", "LED Copy", "Sleep", "EEPROM",
+};
+#endif
+
+#if LOGGING_ENABLED && LOGGING_BOOT
+/// Time since reset at which each stage finished, or 0 if it hasn't yet
+static Microseconds boot_stage_times[BOOT_STAGES_NUM];
+static const char boot_stage_names[BOOT_STAGES_NUM][16] PROGMEM = {
+    "IO", "Params Load", "Params Validate", "Mode Init", "LED Init", "First Frame",
+};
+#endif
+
+/* DECLARATIONS */
+
+#if LOGGING_ENABLED && LOGGING_TRIG_LATENCY
+/// Smallest latency which at least `percent` percent of the recorded latencies
+/// don't exceed, to the resolution of the histogram's buckets
+static Microseconds trig_latency_percentile(uint8_t percent);
+#endif
+
 /* EXTERNAL */
 
 void logging_init() {
 #if LOGGING_ENABLED
-	Serial.begin(9600);
+	Serial.begin(SERIAL_BAUD);
+#endif
+}
+
+void log_loop_stage_begin() {
+#if LOGGING_ENABLED && LOGGING_STAGES
+	loop_stage_start = micros();
+#endif
+}
+
+void log_loop_stage_end(LoopStage stage) {
+#if LOGGING_ENABLED && LOGGING_STAGES
+	Microseconds time = micros() - loop_stage_start;
+	uint8_t bucket = 0;
+	while (time && (bucket < STAGE_HISTOGRAM_BUCKETS - 1)) {
+		time >>= 1;
+		bucket++;
+	}
+
+	uint16_t *count = &loop_stage_histograms[stage][bucket];
+	if (*count < UINT16_MAX) {
+		(*count)++;
+	}
+#endif
+}
+
+void log_loop_stages() {
+#if LOGGING_ENABLED && LOGGING_STAGES
+	// Early return: Not requested
+	if (Serial.read() != STAGE_HISTOGRAMS_REQUEST) return;
+
+	Serial.print(F("Stage Histograms, buckets up to us:"));
+	for (uint8_t bucket = 0; bucket < STAGE_HISTOGRAM_BUCKETS - 1; bucket++) {
+		Serial.print(' ');
+		Serial.print(((Microseconds)1 << bucket) - 1);
+	}
+	Serial.println(F(" more"));
+
+	for (uint8_t stage = 0; stage < LOOP_STAGES_NUM; stage++) {
+		Serial.print((const __FlashStringHelper *)loop_stage_names[stage]);
+		Serial.print(':');
+		for (uint8_t bucket = 0; bucket < STAGE_HISTOGRAM_BUCKETS; bucket++) {
+			Serial.print(' ');
+			Serial.print(loop_stage_histograms[stage][bucket]);
+		}
+		Serial.println();
+	}
+	memset(loop_stage_histograms, 0, sizeof(loop_stage_histograms));
+#endif
+}
+
+void log_boot_stage(BootStage stage) {
+#if LOGGING_ENABLED && LOGGING_BOOT
+	// Early return: Already recorded
+	if (boot_stage_times[stage]) return;
+	boot_stage_times[stage] = micros();
+
+	// Early return: Still booting
+	if (stage != BOOT_STAGE_FIRST_FRAME) return;
+
+	Microseconds previous = 0;
+	for (uint8_t s = 0; s < BOOT_STAGES_NUM; s++) {
+		Serial.print(F("Boot: "));
+		Serial.print((const __FlashStringHelper *)boot_stage_names[s]);
+		Serial.print(F(" @"));
+		Serial.print(boot_stage_times[s]);
+		Serial.print(F("us (+"));
+		Serial.print(boot_stage_times[s] - previous);
+		Serial.println(F("us)"));
+		previous = boot_stage_times[s];
+	}
 #endif
 }
 
 void log_cycle_time_begin() {
-#if LOGGING_ENABLED && LOGGING_CYCLE_TIME
+#if CYCLE_TIME_MEASURED
 	cycle_time_start = micros();
 #endif
 }
 
 void log_cycle_time_end(Milliseconds now) {
-#if LOGGING_ENABLED && LOGGING_CYCLE_TIME
+#if CYCLE_TIME_MEASURED
 	const Microseconds cycle_time = micros() - cycle_time_start;
+	if (cycle_time > cycle_time_recent_max) {
+		cycle_time_recent_max = cycle_time;
+	}
+#endif
+
+#if LOGGING_ENABLED && LOGGING_CYCLE_TIME
 	if (cycle_time > cycle_time_max) {
 		cycle_time_max = cycle_time;
 	}
+	cycle_time_total += cycle_time;
+	cycle_count++;
 
 	if (timeout_loop(&log_cycle_time_timeout, now)) {
-		Serial.print("Max Cycle Time: ");
+		Serial.print(F("Max Cycle Time: "));
 		Serial.println(cycle_time_max);
+		Serial.print(F("Avg Cycle Time: "));
+		Serial.println(cycle_time_total / cycle_count);
 		cycle_time_max = 0;
+		cycle_time_total = 0;
+		cycle_count = 0;
 	}
 #endif
 }
 
+Microseconds log_cycle_time_recent_max() {
+#if CYCLE_TIME_MEASURED
+	const Microseconds result = cycle_time_recent_max;
+	cycle_time_recent_max = 0;
+	return result;
+#else
+	return 0;
+#endif
+}
+
 void log_eeprom_write(Mode mode, ParamIdx idx, Address addr, uint8_t val) {
 #if LOGGING_ENABLED && LOGGING_EEPROM
 	char name[PARAM_NAME_LEN];
 	mode_param_name(name, mode, idx);
 
-	Serial.print("EEPROM Write: ");
+	Serial.print(F("EEPROM Write: "));
 	Serial.print(name);
-	Serial.print(" @");
+	Serial.print(F(" @"));
 	Serial.print(addr);
-	Serial.print(": ");
+	Serial.print(F(": "));
 	Serial.println(val);
 #endif
 }
 
+void log_param_write_suppressed() {
+#if LOGGING_ENABLED && LOGGING_EEPROM
+	param_writes_suppressed++;
+#endif
+}
+
+void log_suppressed_writes(Milliseconds now) {
+#if LOGGING_ENABLED && LOGGING_EEPROM
+	if (!timeout_loop(&log_suppressed_timeout, now)) return;
+
+	Serial.print(F("Writes Suppressed: Params "));
+	Serial.print(param_writes_suppressed);
+	Serial.print(F(" EEPROM "));
+	Serial.println(eeprom_queue_unchanged_take());
+	param_writes_suppressed = 0;
+#endif
+}
+
 void log_input_events(const InputEvents *events) {
 #if LOGGING_ENABLED && LOGGING_INPUT
 	if (events->reset) {
-		Serial.println("INPUT: Reset");
+		Serial.println(F("INPUT: Reset"));
 	}
 	if (events->trig) {
-		Serial.println("INPUT: Trigger");
+		Serial.println(F("INPUT: Trigger"));
 	}
 	if (events->enc_move[ENCODER_1] != 0) {
-		Serial.print("ENC_1: Move ");
+		Serial.print(F("ENC_1: Move "));
 		Serial.println(events->enc_move[ENCODER_1]);
 	}
 	if (events->enc_move[ENCODER_2] != 0) {
-		Serial.print("ENC_2: Move ");
+		Serial.print(F("ENC_2: Move "));
 		Serial.println(events->enc_move[ENCODER_2]);
 	}
 	if (events->enc_move[ENCODER_3] != 0) {
-		Serial.print("ENC_3: Move ");
+		Serial.print(F("ENC_3: Move "));
 		Serial.println(events->enc_move[ENCODER_3]);
 	}
 #endif
@@ -80,20 +284,199 @@ void log_input_events(const InputEvents *events) {
 
 void log_all_modified_params(const Params *params, Mode mode) {
 #if LOGGING_ENABLED
-	const uint8_t num_params = mode_num_params[mode];
-
-	for (uint8_t idx = 0; idx < num_params; idx++) {
-		bool modified = param_flags_get(params, idx, PARAM_FLAG_MODIFIED);
-		if (!modified) continue;
+	for (ParamBits modified = params->modified; modified; modified &= modified - 1) {
+		const ParamIdx idx = param_bits_first(modified);
 
 		uint8_t val = params->values[idx];
 		char name[PARAM_NAME_LEN];
 		mode_param_name(name, mode, idx);
 
-		Serial.print("Param ");
+		Serial.print(F("Param "));
 		Serial.print(name);
-		Serial.print(": ");
+		Serial.print(F(": "));
 		Serial.println(val);
 	}
 #endif
-}
\ No newline at end of file
+}
+
+void log_task_deadline_misses(const Task *tasks, uint8_t num_tasks, Milliseconds now) {
+#if LOGGING_ENABLED && LOGGING_SCHEDULER
+	if (!timeout_loop(&log_scheduler_timeout, now)) return;
+
+	Serial.print(F("Deadline Misses:"));
+	for (uint8_t idx = 0; idx < num_tasks; idx++) {
+		Serial.print(F(" "));
+		Serial.print(tasks[idx].deadline_misses);
+	}
+	Serial.println();
+#endif
+}
+
+void log_output_high() {
+#if LOGGING_ENABLED && LOGGING_TRIG_LATENCY
+	if (output_high_recorded) return;
+
+	output_high_time = micros();
+	output_high_recorded = true;
+#endif
+}
+
+void log_trig_output_latency_record(bool trig) {
+#if LOGGING_ENABLED && LOGGING_TRIG_LATENCY
+	const bool measured = trig && output_high_recorded;
+	output_high_recorded = false;
+
+	// Early return: No output was set high in response to a trig
+	if (!measured) return;
+
+	// The trig monitor timestamps the edge itself. Otherwise, the time at which
+	// it was polled is the closest there is.
+	const Microseconds edge_time = (TRIG_MONITOR) ? trig_monitor_rise_time() : input_trig_time();
+	const Microseconds latency = output_high_time - edge_time;
+
+	const uint8_t bucket = MIN(latency / TRIG_LATENCY_BUCKET_WIDTH, TRIG_LATENCY_BUCKETS - 1);
+	if (trig_latency_histogram[bucket] == UINT16_MAX) {
+		trig_latency_count = 0;
+		for (uint8_t b = 0; b < TRIG_LATENCY_BUCKETS; b++) {
+			trig_latency_histogram[b] /= 2;
+			trig_latency_count += trig_latency_histogram[b];
+		}
+	}
+	trig_latency_histogram[bucket]++;
+	trig_latency_count++;
+
+	trig_latency_min = MIN(trig_latency_min, latency);
+	trig_latency_max = MAX(trig_latency_max, latency);
+#endif
+}
+
+void log_trig_output_latency(Milliseconds now) {
+#if LOGGING_ENABLED && LOGGING_TRIG_LATENCY
+	if (!timeout_loop(&log_trig_latency_timeout, now)) return;
+	if (trig_latency_count == 0) return;
+
+	// Jitter is the spread from the median to the 99th percentile, so that a
+	// few outliers don't dominate it the way they dominate the max
+	const Microseconds median = trig_latency_percentile(50);
+	const Microseconds p99 = trig_latency_percentile(99);
+
+	Serial.print(F("Trig Latency: Min "));
+	Serial.print(trig_latency_min);
+	Serial.print(F(" Median "));
+	Serial.print(median);
+	Serial.print(F(" P99 "));
+	Serial.print(p99);
+	Serial.print(F(" Max "));
+	Serial.print(trig_latency_max);
+	Serial.print(F(" Jitter "));
+	Serial.println(p99 - median);
+#endif
+}
+
+void log_trig_monitor(Milliseconds now) {
+#if LOGGING_ENABLED && LOGGING_TRIG && TRIG_MONITOR
+	if (!timeout_loop(&log_trig_timeout, now)) return;
+
+	TrigMonitorStats stats;
+	trig_monitor_stats(&stats);
+	trig_monitor_reset_extremes();
+
+	Serial.print(F("Trig Edges Missed: "));
+	Serial.println(stats.edges_seen - stats.edges_consumed);
+	if (stats.pulse_width_min != UINT32_MAX) {
+		Serial.print(F("Trig Pulse Min: "));
+		Serial.println(stats.pulse_width_min);
+	}
+	Serial.print(F("Max Loop Gap: "));
+	Serial.println(stats.poll_gap_max);
+#endif
+}
+
+void log_led_row_copy(bool transferred) {
+#if LOGGING_ENABLED && LOGGING_LED
+	if (transferred) {
+		led_rows_sent++;
+	} else {
+		led_rows_skipped++;
+	}
+#endif
+}
+
+void log_led_frame_begin() {
+#if LOGGING_ENABLED && LOGGING_LED
+	led_frame_start = micros();
+#endif
+}
+
+void log_led_frame_end() {
+#if LOGGING_ENABLED && LOGGING_LED
+	const Microseconds latency = micros() - led_frame_start;
+	if (latency > led_frame_latency_max) {
+		led_frame_latency_max = latency;
+	}
+#endif
+}
+
+void log_led_refresh(Microseconds refresh_time) {
+#if LOGGING_ENABLED && LOGGING_LED
+	if (refresh_time > led_refresh_time_max) {
+		led_refresh_time_max = refresh_time;
+	}
+#endif
+}
+
+void log_led_rows(Milliseconds now) {
+#if LOGGING_ENABLED && LOGGING_LED
+	if (!timeout_loop(&log_led_timeout, now)) return;
+
+	Serial.print(F("LED Rows Sent: "));
+	Serial.print(led_rows_sent);
+	Serial.print(F(" Skipped: "));
+	Serial.print(led_rows_skipped);
+	Serial.print(F(" Max Frame Latency: "));
+	Serial.print(led_frame_latency_max);
+	Serial.print(F(" Max Refresh Time: "));
+	Serial.println(led_refresh_time_max);
+	led_rows_sent = 0;
+	led_rows_skipped = 0;
+	led_frame_latency_max = 0;
+	led_refresh_time_max = 0;
+#endif
+}
+
+void log_channel_redraw() {
+#if LOGGING_ENABLED && LOGGING_REDRAW
+	channel_redraws++;
+#endif
+}
+
+void log_channel_redraws(Milliseconds now) {
+#if LOGGING_ENABLED && LOGGING_REDRAW
+	if (!timeout_loop(&log_redraw_timeout, now)) return;
+
+	// Scale to a rate, in case the interval isn't one second
+	const uint32_t per_second = ((uint32_t)channel_redraws * 1000) / LOGGING_CYCLE_TIME_INTERVAL;
+	Serial.print(F("Channel Redraws/s: "));
+	Serial.println(per_second);
+	channel_redraws = 0;
+#endif
+}
+
+/* INTERNAL */
+
+#if LOGGING_ENABLED && LOGGING_TRIG_LATENCY
+static Microseconds trig_latency_percentile(uint8_t percent) {
+	const uint32_t threshold = ((trig_latency_count * percent) + 99) / 100;
+
+	uint32_t seen = 0;
+	uint8_t bucket = 0;
+	for (; bucket < TRIG_LATENCY_BUCKETS - 1; bucket++) {
+		seen += trig_latency_histogram[bucket];
+		if (seen >= threshold) break;
+	}
+
+	// Report the top of the bucket, which is never more than the largest latency
+	const Microseconds bucket_top = ((Microseconds)(bucket + 1) * TRIG_LATENCY_BUCKET_WIDTH) - 1;
+	return MIN(bucket_top, trig_latency_max);
+}
+#endif
@@ -9,13 +9,104 @@ extern "C" {
 #include "common/types.h"
 #include "config.h"
 #include "mode/mode.h"
+#include "scheduler.h"
+
+/// Stages of booting, in the order they finish
+typedef enum BootStage {
+	/// Everything needed to respond to trigs is initialized
+	BOOT_STAGE_IO,
+	BOOT_STAGE_PARAMS_LOAD,
+	BOOT_STAGE_PARAMS_VALIDATE,
+	/// The active mode is initialized, and the main loop is about to begin
+	BOOT_STAGE_MODE_INIT,
+	/// The LED matrix is initialized, on the first idle cycle
+	BOOT_STAGE_LED_INIT,
+	/// Every row of the first frame has been sent to the LED matrix
+	BOOT_STAGE_FIRST_FRAME,
+	BOOT_STAGES_NUM,
+} BootStage;
+
+/// Stages of the main loop which are timed separately
+typedef enum LoopStage {
+	LOOP_STAGE_INPUT,
+	LOOP_STAGE_CLOCK,
+	LOOP_STAGE_MODE_UPDATE,
+	LOOP_STAGE_INDICATORS,
+	LOOP_STAGE_ANIMATIONS,
+	LOOP_STAGE_LED_COPY,
+	LOOP_STAGE_SLEEP,
+	LOOP_STAGE_EEPROM,
+	LOOP_STAGES_NUM,
+} LoopStage;
+
+/// Time the code between `LOOP_STAGE_BEGIN()` and `LOOP_STAGE_END(stage)`, and
+/// add it to the stage's histogram. Stages can't be nested. These compile to
+/// nothing unless stage logging is enabled.
+#if LOGGING_ENABLED && LOGGING_STAGES
+#define LOOP_STAGE_BEGIN() log_loop_stage_begin()
+#define LOOP_STAGE_END(stage) log_loop_stage_end(stage)
+#else
+#define LOOP_STAGE_BEGIN()
+#define LOOP_STAGE_END(stage)
+#endif
 
 void logging_init();
+void log_loop_stage_begin();
+void log_loop_stage_end(LoopStage stage);
+/// Print the histogram of each loop stage's time if it was requested over
+/// serial, and clear them.
+void log_loop_stages();
+/// Record the time at which a stage of booting finished. Only the first call
+/// for each stage is recorded. The times are logged once the last stage has
+/// finished, so logging doesn't slow down booting.
+void log_boot_stage(BootStage stage);
 void log_cycle_time_begin();
 void log_cycle_time_end(Milliseconds now);
+/// Longest cycle time since this was last called. Cycle time is measured when
+/// either cycle time logging or the performance overlay is enabled, even if
+/// logging over serial is disabled.
+Microseconds log_cycle_time_recent_max();
 void log_eeprom_write(Mode mode, ParamIdx idx, Address addr, uint8_t val);
+/// Count a param being set to the value it already had
+void log_param_write_suppressed();
+/// Periodically log the number of param writes that were suppressed because
+/// the value was unchanged, in the params and in the EEPROM.
+void log_suppressed_writes(Milliseconds now);
 void log_input_events(const InputEvents *events);
 void log_all_modified_params(const Params *params, Mode mode);
+/// Periodically log the deadline miss counters of the scheduler's tasks
+void log_task_deadline_misses(const Task *tasks, uint8_t num_tasks, Milliseconds now);
+/// Note that an output has just gone high
+void log_output_high();
+/// Measure the time from the trig edge to the first output going high, if this
+/// cycle's sequencer update received a trig and set an output high. Must be
+/// called after every sequencer update.
+void log_trig_output_latency_record(bool trig);
+/// Periodically log the minimum, median, 99th percentile and maximum time from
+/// a trig edge to an output going high, since booting, and the jitter as the
+/// 99th percentile minus the median. Percentiles are read from a histogram, so
+/// are accurate to within 32 µs.
+void log_trig_output_latency(Milliseconds now);
+/// Periodically log the trig monitor's missed triggers, shortest trig pulse and
+/// longest gap between polls of the trig input
+void log_trig_monitor(Milliseconds now);
+/// Count a dirty row of the framebuffer being copied to the LED matrix.
+/// @param transferred `true` if the row was sent, `false` if it was skipped
+/// because the LED matrix already shows the same pixels.
+void log_led_row_copy(bool transferred);
+/// Mark the start of sending a newly latched frame to the LED matrix
+void log_led_frame_begin();
+/// Mark the last row of a frame being sent to the LED matrix
+void log_led_frame_end();
+/// Record the time taken sending rows to the LED matrix during one cycle
+void log_led_refresh(Microseconds refresh_time);
+/// Periodically log the number of rows sent to, and skipped for, the LED
+/// matrix, along with the max frame latency and refresh time per cycle.
+void log_led_rows(Milliseconds now);
+/// Count a sequencer channel being redrawn into the framebuffer
+void log_channel_redraw();
+/// Periodically log the number of sequencer channels redrawn per second
+void log_channel_redraws(Milliseconds now);
 
 #ifdef __cplusplus
 }
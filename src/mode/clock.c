@@ -7,11 +7,18 @@ static Timeout internal_clock_timeout = {.duration = INTERNAL_CLOCK_PERIOD};
 
 static bool internal_clock_enabled = INTERNAL_CLOCK_DEFAULT;
 
+/// Time of the last external clock trig, and the time since the one before it
+static Milliseconds external_clock_last_trig;
+static Milliseconds external_clock_period = 0;
+
 // cppcheck-suppress unusedFunction
 void internal_clock_update(InputEvents *events, Milliseconds now) {
 	// Turn off internal clock when external clock received
 	if (events->trig) {
 		internal_clock_enabled = false;
+
+		external_clock_period = now - external_clock_last_trig;
+		external_clock_last_trig = now;
 	}
 
 	if (events->reset) {
@@ -21,4 +28,24 @@ void internal_clock_update(InputEvents *events, Milliseconds now) {
 	if (internal_clock_enabled && (timeout_loop(&internal_clock_timeout, now))) {
 		events->internal_clock_tick = true;
 	}
-}
\ No newline at end of file
+}
+
+// cppcheck-suppress unusedFunction
+Milliseconds internal_clock_next_tick(Milliseconds now) {
+	if (!internal_clock_enabled) {
+		return now + DEADLINE_NONE_INTERVAL;
+	}
+	return timeout_deadline(&internal_clock_timeout);
+}
+
+// cppcheck-suppress unusedFunction
+Milliseconds external_clock_next_trig(Milliseconds now) {
+	const Milliseconds expected = external_clock_last_trig + external_clock_period;
+
+	// A clock that has stopped, or hasn't started, can't be predicted
+	if (external_clock_period == 0 || external_clock_period > DEADLINE_NONE_INTERVAL ||
+	    deadline_reached(expected, now)) {
+		return now + DEADLINE_NONE_INTERVAL;
+	}
+	return expected;
+}
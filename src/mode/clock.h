@@ -13,6 +13,15 @@ extern "C" {
 /// clock tick event if one should be generated this cycle.
 void internal_clock_update(InputEvents *events, Milliseconds now);
 
+/// The time of the internal clock's next tick, or a time far in the future if
+/// the internal clock is disabled.
+Milliseconds internal_clock_next_tick(Milliseconds now);
+
+/// When the next external clock trig is expected, assuming the clock keeps the
+/// same period as its last two trigs, or a time far in the future if there is
+/// no steady external clock.
+Milliseconds external_clock_next_trig(Milliseconds now);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,28 +3,54 @@
 #include "common/math.h"
 #include "config.h"
 #include "hardware/output.h"
+#include "logging.h"
+#include "mode/euclid_presets.h"
 #include "ui/active_channel.h"
 #include "ui/indicators.h"
+#include "ui/led_sleep.h"
 
+#include <avr/pgmspace.h>
 #include <euclidean.h>
+#include <string.h>
 
 /* CONSTANTS */
 
 static const uint8_t EUCLID_PARAMS_PER_CHANNEL = 3;
+/// Time between attempts to queue a stored preset that the EEPROM write queue
+/// had no room for. Each queued byte takes about 3.3 ms to be written.
+static const Milliseconds PRESET_STORE_RETRY_TIME = 10;
+
+/*
+Original EEPROM Schema:
+Channel 1: length = 1 density = 2 offset = 7
+Channel 2: length = 3 density = 4 offset = 8
+Channel 3: length = 5 density = 6 offset = 9
+*/
+// Each channel has a length (N), a density (K) of at most its length, and an
+// offset (O) of less than its length. The EEPROM addresses are in this order
+// for backwards-compatibility with the original Sebsongs Euclidean firmware.
+// clang-format off
+const ParamInfo euclid_param_infos[EUCLID_NUM_PARAMS] PROGMEM = {
+	{.addr = 1, .min = 1, .max = 16, .default_value = 16, .bound_by = PARAM_IDX_NONE, .bound_margin = 0, .name = "L1"},
+	{.addr = 2, .min = 0, .max = 16, .default_value = 4,  .bound_by = 0,              .bound_margin = 0, .name = "D1"},
+	{.addr = 7, .min = 0, .max = 15, .default_value = 0,  .bound_by = 0,              .bound_margin = 1, .name = "O1"},
+	{.addr = 3, .min = 1, .max = 16, .default_value = 16, .bound_by = PARAM_IDX_NONE, .bound_margin = 0, .name = "L2"},
+	{.addr = 4, .min = 0, .max = 16, .default_value = 4,  .bound_by = 3,              .bound_margin = 0, .name = "D2"},
+	{.addr = 8, .min = 0, .max = 15, .default_value = 0,  .bound_by = 3,              .bound_margin = 1, .name = "O2"},
+	{.addr = 5, .min = 1, .max = 16, .default_value = 16, .bound_by = PARAM_IDX_NONE, .bound_margin = 0, .name = "L3"},
+	{.addr = 6, .min = 0, .max = 16, .default_value = 4,  .bound_by = 6,              .bound_margin = 0, .name = "D3"},
+	{.addr = 9, .min = 0, .max = 15, .default_value = 0,  .bound_by = 6,              .bound_margin = 1, .name = "O3"},
+};
+// clang-format on
 
-// Bounds for three channel parameters
-// Length (N)
-static const uint8_t PARAM_LENGTH_MIN = 1;
-static const uint8_t PARAM_LENGTH_MAX = 16;
-static const uint8_t PARAM_LENGTH_DEFAULT = 16;
-// Density (K)
-static const uint8_t PARAM_DENSITY_MIN = 0;
-static const uint8_t PARAM_DENSITY_MAX = 16;
-static const uint8_t PARAM_DENSITY_DEFAULT = 4;
-// Offset (O)
-static const uint8_t PARAM_OFFSET_MIN = 0;
-static const uint8_t PARAM_OFFSET_MAX = 15;
-static const uint8_t PARAM_OFFSET_DEFAULT = 0;
+// Each byte with its bits in reverse order, indexed by the byte itself
+#define R2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define R4(n) R2(n), R2(n + 2 * 16), R2(n + 1 * 16), R2(n + 3 * 16)
+#define R6(n) R4(n), R4(n + 2 * 4), R4(n + 1 * 4), R4(n + 3 * 4)
+static const uint8_t BITS_REVERSED[256] PROGMEM = {R6(0), R6(2), R6(1), R6(3)};
+#undef R2
+#undef R4
+#undef R6
 
 /* DATA STRUCTURES */
 
@@ -44,7 +70,7 @@ typedef struct EuclidParamOpt {
 static const EuclidParamOpt EUCLID_PARAM_OPT_NONE = {.inner = EUCLID_PARAM_LENGTH, .valid = false};
 
 // clang-format off
-static const EuclidState EUCLID_STATE_INIT = {
+static const EuclidState EUCLID_STATE_INIT PROGMEM = {
     // First channel is selected on init
     .active_channel = CHANNEL_1,
     .generated_rhythms = {0, 0, 0},
@@ -66,16 +92,44 @@ static const EuclidState EUCLID_STATE_INIT = {
 			.idle_timeout = {.duration = PLAYHEAD_IDLE_TIME},
 			.idle_loop_timeout = {.duration = PLAYHEAD_IDLE_LOOP_PERIOD},
 		},
+		.presets = {
+			.loaded = {.bank = EUCLID_PRESET_NONE},
+			.page_visible = false,
+			.cursor = 0,
+			.cued = EUCLID_PRESET_NONE,
+			.recalled = EUCLID_PRESET_NONE,
+			.store_armed = EUCLID_PRESET_NONE,
+			.store_arm_timeout = {.duration = PRESET_STORE_ARM_TIME},
+			.store_pending = EUCLID_PRESET_NONE,
+		},
+		.params_cue = {.cued = false},
+		.channels_redraw = {EUCLID_REDRAW_NONE, EUCLID_REDRAW_NONE, EUCLID_REDRAW_NONE},
 };
 // clang-format on
 
 /* DECLARATIONS */
 
 static void euclid_handle_encoder_push(EuclidState *state, EncoderIdx enc_idx);
-static EuclidParamOpt euclid_handle_encoder_move(EuclidState *state, Params *params, const int16_t *enc_move);
+static void euclid_draw_channel_select_row(const EuclidState *state, Framebuffer *fb);
+/// @param param_changed Set to `true` if a param's value changed, which it
+/// doesn't when a knob is turned against the param's limit
+/// @return The param of the last knob that was moved, if any
+static EuclidParamOpt euclid_handle_encoder_move(EuclidState *state, Params *params, const int16_t *enc_move,
+                                                 bool *param_changed);
 // Returns bitflags storing which output channels will fire this cycle, indexed
 // by `OutputChannel`.
 static uint8_t euclid_update_sequencers(EuclidState *state, const Params *params, const InputEvents *events);
+/// Replace the params and generated rhythms with the cued values, if there are
+/// any. Must be called on a clock boundary, before the sequencers read their
+/// current step.
+/// @return `true` if the params were replaced
+static bool params_cue_recall(EuclidState *state, Params *params);
+/// Adjust a param with `param_adjust()`, counting adjustments that didn't change
+/// anything, such as when a knob is turned against a param's limit
+/// @return `true` if any param's value changed
+static bool euclid_param_adjust(Params *params, ParamIdx idx, int16_t delta);
+/// Generate the Euclidean rhythm for a single channel, based on `params`
+static void channel_rhythm_generate(EuclidState *state, const Params *params, Channel channel);
 static void sequencer_handle_reset(EuclidState *state);
 static void sequencer_handle_clock(EuclidState *state, const Params *params);
 static void sequencer_advance(EuclidState *state, const Params *params);
@@ -83,11 +137,24 @@ static void sequencer_advance(EuclidState *state, const Params *params);
 /// @return Bitflags, indexed using `OutputChannel`. 1 = begin an output pulse this cycle for this channel, 0
 /// = do nothing for this channel
 static uint8_t sequencer_read_current_step(EuclidState *state, const Params *params);
-static void euclid_draw_channels(const EuclidState *state, Framebuffer *fb, const Params *params);
+/// Redraw the channels that have a reason to be redrawn, and clear their reasons
+static void euclid_draw_channels(EuclidState *state, Framebuffer *fb, const Params *params);
+/// Add reasons for a channel to be redrawn
+static inline void channel_redraw_mark(EuclidState *state, Channel channel, uint8_t reasons);
+/// Add reasons for every channel to be redrawn
+static inline void channels_redraw_mark_all(EuclidState *state, uint8_t reasons);
+/// Hide the length adjustment display, if it is visible
+static void adjustment_display_hide(EuclidState *state);
 static inline void draw_channel(const EuclidState *state, Framebuffer *fb, Channel channel, uint8_t length);
-static inline void draw_channel_length(Framebuffer *fb, Channel channel, uint16_t pattern, uint8_t length);
-static inline void draw_channel_pattern(const EuclidState *state, Framebuffer *fb, Channel channel,
+/// Draw the steps beyond the pattern's length into the bitplanes of a channel's
+/// two rows, where bit `n` is the pixel for step `n`.
+static inline void draw_channel_length(uint16_t *plane_low, uint16_t *plane_high, uint8_t length);
+/// Draw the pattern's steps and playhead into the bitplanes of a channel's two
+/// rows, where bit `n` is the pixel for step `n`.
+static inline void draw_channel_pattern(const EuclidState *state, uint16_t *plane_low, uint16_t *plane_high,
                                         uint16_t pattern, uint8_t length, uint8_t position);
+/// Reverse the order of the bits in a pattern
+static inline uint16_t pattern_reverse(uint16_t pattern);
 /// Read a single step from a pattern
 /// @param pattern The pattern to read from, stored as 16 bitflags.
 /// @param length The length of the pattern. Must be <= 16.
@@ -101,66 +168,58 @@ static inline EuclidParamOpt euclid_param_opt(EuclidParam inner);
 /// Return the `ParamIdx` for a given a channel and param kind
 static inline ParamIdx euclid_param_idx(Channel channel, EuclidParam kind);
 static inline uint8_t euclid_param_get(const Params *params, Channel channel, EuclidParam kind);
-static inline void euclid_param_set(Params *params, Channel channel, EuclidParam kind, uint8_t val);
 static inline uint8_t euclid_get_length(const Params *params, Channel channel);
 static inline uint8_t euclid_get_density(const Params *params, Channel channel);
 static inline uint8_t euclid_get_offset(const Params *params, Channel channel);
 
 /* EXTERNAL */
 
-void euclid_params_validate(Params *params) {
-	for (uint8_t c = 0; c < NUM_CHANNELS; c++) {
-		Channel channel = (Channel)c;
-		uint8_t length = euclid_get_length(params, channel);
-		uint8_t density = euclid_get_density(params, channel);
-		uint8_t offset = euclid_get_offset(params, channel);
-
-		if ((length > PARAM_LENGTH_MAX) || (length < PARAM_LENGTH_MIN)) {
-			euclid_param_set(params, channel, EUCLID_PARAM_LENGTH, PARAM_LENGTH_DEFAULT);
-		}
-		if (density > PARAM_DENSITY_MAX || density > length) {
-			euclid_param_set(params, channel, EUCLID_PARAM_DENSITY, PARAM_DENSITY_DEFAULT);
-		}
-		if (offset > PARAM_OFFSET_MAX || offset > length) {
-			euclid_param_set(params, channel, EUCLID_PARAM_OFFSET, PARAM_OFFSET_DEFAULT);
-		}
-	}
-}
+void euclid_params_validate(Params *params) { params_validate(params, euclid_param_infos); }
 
 void euclid_init(EuclidState *state, const Params *params, Framebuffer *fb) {
-	*state = EUCLID_STATE_INIT;
+	memcpy_P(state, &EUCLID_STATE_INIT, sizeof(*state));
 
 	// Initialise generated rhythms based on params
-	for (int a = 0; a < NUM_CHANNELS; a++) {
-		const Channel channel = (Channel)a;
+	euclid_rhythms_generate(state->generated_rhythms, params);
+
+	// Draw initial UI. The channels are drawn by the first update, so that
+	// booting doesn't wait on drawing them.
+	channels_redraw_mark_all(state, EUCLID_REDRAW_PATTERN);
+	euclid_draw_channel_select_row(state, fb);
+}
+
+void euclid_rhythms_generate(uint16_t *rhythms, const Params *params) {
+	for (uint8_t c = 0; c < NUM_CHANNELS; c++) {
+		const Channel channel = (Channel)c;
 		const uint8_t length = euclid_get_length(params, channel);
 		const uint8_t density = euclid_get_density(params, channel);
 		const uint8_t offset = euclid_get_offset(params, channel);
-		state->generated_rhythms[a] = euclidean_pattern_rotate(length, density, offset);
+		rhythms[channel] = euclidean_pattern_rotate(length, density, offset);
 	}
-
-	// Draw initial UI
-	euclid_draw_channels(state, fb, params);
-	active_channel_display_draw(fb, state->active_channel);
 }
 
 void euclid_update(EuclidState *state, Params *params, Framebuffer *fb, const InputEvents *events,
                    Milliseconds now) {
 	euclid_handle_encoder_push(state, events->enc_push);
 
-	// Note the param associated with a knob that was moved so we can re-generate
-	// the Euclidean rhythms and show the adjustment display.
-	const EuclidParamOpt param_knob_moved = euclid_handle_encoder_move(state, params, events->enc_move);
+	// Note the param associated with a knob that was moved so we can show the
+	// adjustment display, and whether it changed so we can re-generate the
+	// Euclidean rhythms. While the preset page is visible, the knobs control
+	// presets instead.
+	EuclidParamOpt param_knob_moved = EUCLID_PARAM_OPT_NONE;
+	bool param_changed = false;
+	bool channel_select_row_updated = (events->enc_push != ENCODER_NONE);
+	channel_select_row_updated |= euclid_presets_update(&state->presets, now);
+	if (state->presets.page_visible) {
+		channel_select_row_updated |= euclid_presets_handle_encoder_move(state, params, events->enc_move, now);
+	} else {
+		param_knob_moved = euclid_handle_encoder_move(state, params, events->enc_move, &param_changed);
+	}
 
 	// Update Generated Rhythms Based On Parameter Changes
 	Channel active_channel = state->active_channel;
-	if (param_knob_moved.valid) {
-		const Channel channel = active_channel;
-		const uint8_t length = euclid_get_length(params, channel);
-		const uint8_t density = euclid_get_density(params, channel);
-		const uint8_t offset = euclid_get_offset(params, channel);
-
-		state->generated_rhythms[channel] = euclidean_pattern_rotate(length, density, offset);
+	if (param_changed) {
+		channel_rhythm_generate(state, params, active_channel);
 	}
 
 	/* UPDATE SEQUENCER */
@@ -171,6 +230,18 @@ void euclid_update(EuclidState *state, Params *params, Framebuffer *fb, const In
 	// Tracks if any of the sequencers' states have been updated this cycle
 	const bool sequencers_updated = (clock_tick || events->reset);
 
+	// Swap in a cued preset exactly on the clock boundary, so that this step is
+	// already read from its patterns
+	if (clock_tick && euclid_presets_recall(state, params)) {
+		adjustment_display_hide(state);
+		channels_redraw_mark_all(state, EUCLID_REDRAW_PATTERN);
+		channel_select_row_updated = true;
+	}
+	if (clock_tick && params_cue_recall(state, params)) {
+		adjustment_display_hide(state);
+		channels_redraw_mark_all(state, EUCLID_REDRAW_PATTERN);
+	}
+
 	// Bitflags storing which output channels will fire this cycle, indexed by
 	// `OutputChannel`.
 	const uint8_t out_channels_firing = euclid_update_sequencers(state, params, events);
@@ -200,8 +271,8 @@ void euclid_update(EuclidState *state, Params *params, Framebuffer *fb, const In
 
 	/* DRAWING - ACTIVE CHANNEL DISPLAY */
 
-	if (events->enc_push != ENCODER_NONE) {
-		active_channel_display_draw(fb, active_channel);
+	if (channel_select_row_updated) {
+		euclid_draw_channel_select_row(state, fb);
 	}
 
 	/* DRAWING - CHANNELS */
@@ -218,54 +289,53 @@ void euclid_update(EuclidState *state, Params *params, Framebuffer *fb, const In
 
 		// Reset playhead idle
 		timeout_reset(&state->playhead.idle_timeout, now);
+
+		channels_redraw_mark_all(state, EUCLID_REDRAW_PLAYHEAD | EUCLID_REDRAW_FLASH);
 	}
 
 	// Update playhead idle - Make playhead flash periodically when it hasn't
 	// moved in a certain amount of time
-	bool playhead_flash_updated = false;
 	if (timeout_fired(&state->playhead.idle_timeout, now)) {
 		if (timeout_loop(&state->playhead.idle_loop_timeout, now)) {
 			state->playhead.flash_timeout.inner.duration = PLAYHEAD_FLASH_TIME_DEFAULT;
 			timeout_once_reset(&state->playhead.flash_timeout, now);
-			playhead_flash_updated = true;
+			channels_redraw_mark_all(state, EUCLID_REDRAW_FLASH);
 		}
 	}
 
 	// Update playhead flash
 	if (timeout_once_fired(&state->playhead.flash_timeout, now)) {
-		playhead_flash_updated = true;
+		channels_redraw_mark_all(state, EUCLID_REDRAW_FLASH);
 	}
 
-	// Tracks if the screen needs to be redrawn.
-	bool needs_redraw = sequencers_updated || playhead_flash_updated;
-
 	if (param_knob_moved.valid) {
 		if (param_knob_moved.inner == EUCLID_PARAM_LENGTH) {
-			// If length parameter was changed, reset the adjustment display timeout and state
+			// If the length knob was moved, reset the adjustment display timeout and
+			// state, moving it from any other channel. This is shown even when the
+			// length is already at its limit, so the knob visibly responds.
+			if (state->adjustment_display.channel != active_channel) {
+				adjustment_display_hide(state);
+			}
 			state->adjustment_display.channel = active_channel;
 			state->adjustment_display.visible = true;
 			timeout_reset(&state->adjustment_display.timeout, now);
+			channel_redraw_mark(state, active_channel, EUCLID_REDRAW_LENGTH_DISPLAY);
 		} else {
 			// Otherwise, just hide the adjustment display
-			state->adjustment_display.visible = false;
+			adjustment_display_hide(state);
 		}
-
-		needs_redraw = true;
 	} else {
-		// If no parameters have changed, check if the adjustment display still
+		// If no knobs were moved, check if the adjustment display still
 		// needs to be shown, and hide it if it doesn't
 		if (state->adjustment_display.visible) {
 			bool should_be_hidden = timeout_fired(&state->adjustment_display.timeout, now);
 			if (should_be_hidden) {
-				state->adjustment_display.visible = false;
-				needs_redraw = true;
+				adjustment_display_hide(state);
 			}
 		}
 	}
 
-	if (needs_redraw) {
-		euclid_draw_channels(state, fb, params);
-	}
+	euclid_draw_channels(state, fb, params);
 
 	/* DRAWING - OUTPUT INDICATORS */
 
@@ -274,17 +344,104 @@ void euclid_update(EuclidState *state, Params *params, Framebuffer *fb, const In
 	}
 }
 
+// cppcheck-suppress unusedFunction
+bool euclid_param_write(EuclidState *state, Params *params, ParamIdx idx, uint8_t value) {
+	// Early return: Out of bounds. Params are already valid, so the value only
+	// needs to be checked against the param itself.
+	Params written = *params;
+	written.values[idx] = value;
+	params_validate(&written, euclid_param_infos);
+	if (written.values[idx] != value) return false;
+
+	const Channel channel = (Channel)(idx / EUCLID_PARAMS_PER_CHANNEL);
+	if (euclid_param_adjust(params, idx, (int16_t)value - params->values[idx])) {
+		channel_rhythm_generate(state, params, channel);
+	}
+	if (state->sequencer.positions[channel] >= euclid_get_length(params, channel)) {
+		state->sequencer.positions[channel] = 0;
+	}
+	return true;
+}
+
+// cppcheck-suppress unusedFunction
+bool euclid_params_cue(EuclidState *state, const uint8_t *values) {
+	Params cued = {.len = EUCLID_NUM_PARAMS};
+	memcpy(cued.values, values, EUCLID_NUM_PARAMS);
+	params_validate(&cued, euclid_param_infos);
+
+	// Early return: Out of bounds
+	if (memcmp(cued.values, values, EUCLID_NUM_PARAMS) != 0) return false;
+
+	EuclidParamsCue *cue = &state->params_cue;
+	memcpy(cue->values, values, EUCLID_NUM_PARAMS);
+	euclid_rhythms_generate(cue->rhythms, &cued);
+	cue->cued = true;
+	return true;
+}
+
+Milliseconds euclid_next_deadline(const EuclidState *state, Milliseconds now) {
+	Milliseconds result = now + DEADLINE_NONE_INTERVAL;
+
+	if (state->output_pulse.timeout.active) {
+		result = deadline_earliest(result, timeout_deadline(&state->output_pulse.timeout.inner), now);
+	}
+	if (state->playhead.flash_timeout.active) {
+		result = deadline_earliest(result, timeout_deadline(&state->playhead.flash_timeout.inner), now);
+	}
+	if (state->adjustment_display.visible) {
+		result = deadline_earliest(result, timeout_deadline(&state->adjustment_display.timeout), now);
+	}
+	if (state->presets.store_armed != EUCLID_PRESET_NONE) {
+		result = deadline_earliest(result, timeout_deadline(&state->presets.store_arm_timeout), now);
+	}
+	// Keep retrying until a stored preset has been queued to be written, leaving
+	// the queue time to drain in between
+	if (state->presets.store_pending != EUCLID_PRESET_NONE) {
+		result = deadline_earliest(result, now + PRESET_STORE_RETRY_TIME, now);
+	}
+
+	// Once the playhead is idle, its flash loop takes over
+	const Timeout *playhead_timeout = (timeout_fired(&state->playhead.idle_timeout, now))
+	                                      ? &state->playhead.idle_loop_timeout
+	                                      : &state->playhead.idle_timeout;
+	result = deadline_earliest(result, timeout_deadline(playhead_timeout), now);
+
+	return result;
+}
+
 /* INTERNAL */
 
 static void euclid_handle_encoder_push(EuclidState *state, EncoderIdx enc_idx) {
 	const ChannelOpt active_channel_new = channel_for_encoder(enc_idx);
-	if (active_channel_new.valid) {
+
+	// Early return: No encoder was pushed
+	if (!active_channel_new.valid) return;
+
+	if (state->presets.page_visible) {
+		// Any push leaves the preset page
+		state->presets.page_visible = false;
+	} else if (active_channel_new.inner == state->active_channel) {
+		// Pushing the knob of the channel that is already selected opens the
+		// preset page
+		euclid_presets_page_open(&state->presets);
+	} else {
 		state->active_channel = active_channel_new.inner;
 	}
 }
 
-static EuclidParamOpt euclid_handle_encoder_move(EuclidState *state, Params *params,
-                                                 const int16_t *enc_move) {
+static void euclid_draw_channel_select_row(const EuclidState *state, Framebuffer *fb) {
+	// The performance overlay takes over the channel select row
+	if (PERF_OVERLAY) return;
+
+	if (state->presets.page_visible) {
+		euclid_presets_draw(&state->presets, fb);
+	} else {
+		active_channel_display_draw(fb, state->active_channel);
+	}
+}
+
+static EuclidParamOpt euclid_handle_encoder_move(EuclidState *state, Params *params, const int16_t *enc_move,
+                                                 bool *param_changed) {
 	EuclidParamOpt param_knob_moved = EUCLID_PARAM_OPT_NONE;
 
 	const Channel active_channel = state->active_channel;
@@ -292,87 +449,33 @@ static EuclidParamOpt euclid_handle_encoder_move(EuclidState *state, Params *par
 	const ParamIdx density_idx = euclid_param_idx(active_channel, EUCLID_PARAM_DENSITY);
 	const ParamIdx offset_idx = euclid_param_idx(active_channel, EUCLID_PARAM_OFFSET);
 
-	// Handle Length Knob Movement
-	int nknob = enc_move[ENCODER_1];
+	// Handle Length Knob Movement. Density and offset are reduced to remain in
+	// line with the new length if necessary.
+	const int16_t nknob = enc_move[ENCODER_1];
 	if (nknob != 0) {
 		param_knob_moved = euclid_param_opt(EUCLID_PARAM_LENGTH);
 
 		const Channel channel = active_channel;
-		int length = euclid_get_length(params, channel);
-		uint8_t density = euclid_get_density(params, channel);
-		uint8_t offset = euclid_get_offset(params, channel);
-		const uint8_t position = state->sequencer.positions[channel];
-
-		// Keep length in bounds
-		if (length >= PARAM_LENGTH_MAX) {
-			length = PARAM_LENGTH_MAX;
-		}
-		if (length + nknob > PARAM_LENGTH_MAX) {
-			nknob = 0;
-		}
-		if (length + nknob < PARAM_LENGTH_MIN) {
-			nknob = 0;
-		}
-
-		// Reduce density and offset to remain in line with the new length if necessary
-		if ((density >= (length + nknob)) && (density > 1)) {
-			density += nknob;
-			param_and_flags_set(params, density_idx, density);
-		}
-		if ((offset >= (length + nknob)) && (offset < 16)) {
-			offset += nknob;
-			param_and_flags_set(params, offset_idx, offset);
-		}
-
-		length += nknob;
-		param_and_flags_set(params, length_idx, length);
+		*param_changed |= euclid_param_adjust(params, length_idx, nknob);
 
 		// Reset position if length has been reduced past it
-		if (position >= length) {
+		if (state->sequencer.positions[channel] >= euclid_get_length(params, channel)) {
 			state->sequencer.positions[channel] = 0;
 		}
 	}
 
 	// Handle Density Knob Movement
-	int kknob = enc_move[ENCODER_2];
+	const int16_t kknob = enc_move[ENCODER_2];
 	if (kknob != 0) {
 		param_knob_moved = euclid_param_opt(EUCLID_PARAM_DENSITY);
-
-		const Channel channel = active_channel;
-		const int length = euclid_get_length(params, channel);
-		uint8_t density = euclid_get_density(params, channel);
-
-		// Keep density in bounds
-		if (density + kknob > length) {
-			kknob = 0;
-		}
-		if (density + kknob < PARAM_DENSITY_MIN) {
-			kknob = 0;
-		}
-
-		density += kknob;
-		param_and_flags_set(params, density_idx, density);
+		*param_changed |= euclid_param_adjust(params, density_idx, kknob);
 	}
 
 	// Handle Offset Knob Movement
-	int oknob = enc_move[ENCODER_3];
+	const int16_t oknob = enc_move[ENCODER_3];
 	if (oknob != 0) {
 		param_knob_moved = euclid_param_opt(EUCLID_PARAM_OFFSET);
-
-		const Channel channel = active_channel;
-		const int length = euclid_get_length(params, channel);
-		uint8_t offset = euclid_get_offset(params, channel);
-
-		// Keep offset in bounds
-		if (offset + oknob > length - 1) {
-			oknob = 0;
-		}
-		if (offset + oknob < PARAM_OFFSET_MIN) {
-			oknob = 0;
-		}
-
-		offset += oknob;
-		param_and_flags_set(params, offset_idx, offset);
+		*param_changed |= euclid_param_adjust(params, offset_idx, oknob);
 	}
 
 	return param_knob_moved;
@@ -455,81 +558,119 @@ static uint8_t sequencer_read_current_step(EuclidState *state, const Params *par
 	return out_channels_firing;
 }
 
-static void euclid_draw_channels(const EuclidState *state, Framebuffer *fb, const Params *params) {
+static bool params_cue_recall(EuclidState *state, Params *params) {
+	EuclidParamsCue *cue = &state->params_cue;
+
+	// Early return: Nothing to recall
+	if (!cue->cued) return false;
+
+	for (ParamIdx idx = 0; idx < EUCLID_NUM_PARAMS; idx++) {
+		if (!param_and_flags_set(params, idx, cue->values[idx])) {
+			log_param_write_suppressed();
+		}
+	}
+	memcpy(state->generated_rhythms, cue->rhythms, sizeof(state->generated_rhythms));
+
+	cue->cued = false;
+	return true;
+}
+
+static bool euclid_param_adjust(Params *params, ParamIdx idx, int16_t delta) {
+	const bool changed = param_adjust(params, euclid_param_infos, idx, delta);
+	if (!changed) {
+		log_param_write_suppressed();
+	}
+	return changed;
+}
+
+static void channel_rhythm_generate(EuclidState *state, const Params *params, Channel channel) {
+	const uint8_t length = euclid_get_length(params, channel);
+	const uint8_t density = euclid_get_density(params, channel);
+	const uint8_t offset = euclid_get_offset(params, channel);
+
+	state->generated_rhythms[channel] = euclidean_pattern_rotate(length, density, offset);
+	channel_redraw_mark(state, channel, EUCLID_REDRAW_PATTERN);
+}
+
+static void euclid_draw_channels(EuclidState *state, Framebuffer *fb, const Params *params) {
+	// Nothing is shown while the LED matrix is asleep, so keep collecting reasons
+	// to redraw until it wakes up
+	if (led_sleep_asleep()) return;
+
 	for (uint8_t channel = 0; channel < NUM_CHANNELS; channel++) {
+		if (state->channels_redraw[channel] == EUCLID_REDRAW_NONE) continue;
+
 		const uint8_t length = euclid_get_length(params, channel);
 		draw_channel(state, fb, (Channel)channel, length);
+		state->channels_redraw[channel] = EUCLID_REDRAW_NONE;
+		log_channel_redraw();
 	}
 }
 
+static inline void channel_redraw_mark(EuclidState *state, Channel channel, uint8_t reasons) {
+	state->channels_redraw[channel] |= reasons;
+}
+
+static inline void channels_redraw_mark_all(EuclidState *state, uint8_t reasons) {
+	for (uint8_t channel = 0; channel < NUM_CHANNELS; channel++) {
+		state->channels_redraw[channel] |= reasons;
+	}
+}
+
+static void adjustment_display_hide(EuclidState *state) {
+	if (!state->adjustment_display.visible) return;
+
+	state->adjustment_display.visible = false;
+	channel_redraw_mark(state, state->adjustment_display.channel, EUCLID_REDRAW_LENGTH_DISPLAY);
+}
+
 static inline void draw_channel(const EuclidState *state, Framebuffer *fb, Channel channel, uint8_t length) {
 	const uint8_t position = state->sequencer.positions[channel];
 	const uint16_t pattern = state->generated_rhythms[channel];
 
-	draw_channel_pattern(state, fb, channel, pattern, length, position);
+	uint16_t plane_low;
+	uint16_t plane_high;
+	draw_channel_pattern(state, &plane_low, &plane_high, pattern, length, position);
 
 	const bool showing_length_display =
 	    (state->adjustment_display.visible) && (channel == state->adjustment_display.channel);
 	if (showing_length_display) {
-		draw_channel_length(fb, channel, pattern, length);
+		draw_channel_length(&plane_low, &plane_high, length);
 	}
-}
 
-static inline void draw_channel_length(Framebuffer *fb, Channel channel, uint16_t pattern, uint8_t length) {
+	// Steps 0-7 are on the first row, and steps 8-15 on the second
 	const uint8_t row = channel * 2;
+	framebuffer_row_set_planes(fb, row, (uint8_t)plane_low, (uint8_t)plane_high);
+	framebuffer_row_set_planes(fb, row + 1, (uint8_t)(plane_low >> 8), (uint8_t)(plane_high >> 8));
+}
 
-	for (uint8_t step = length; step < 16; step++) {
-		uint8_t x = step;
-		uint8_t y = row;
-		if (step > 7) {
-			x -= 8;
-			y += 1;
-		}
-
-		framebuffer_pixel_set_fast(fb, x, y, COLOR_ANTS);
-	}
+static inline void draw_channel_length(uint16_t *plane_low, uint16_t *plane_high, uint8_t length) {
+	// `COLOR_ANTS` has both bits set
+	const uint16_t beyond_length = ~((uint16_t)0xFFFF >> (16 - length));
+	*plane_low |= beyond_length;
+	*plane_high |= beyond_length;
 }
 
-static inline void draw_channel_pattern(const EuclidState *state, Framebuffer *fb, Channel channel,
+static inline void draw_channel_pattern(const EuclidState *state, uint16_t *plane_low, uint16_t *plane_high,
                                         uint16_t pattern, uint8_t length, uint8_t position) {
-	const bool playhead_flash_active = state->playhead.flash_timeout.active;
-
-	uint16_t pixel_rows[2] = {0, 0};
-
-	// Optimization - The do/while loop, decrementing iteration, and separate
-	// counter for steps are all faster than otherwise.
-	uint8_t i = length;
-	uint8_t step = length - 1;
-	do {
-		// Optimization - Read current step and shift pattern for next loop. Faster
-		// than pattern_read because index and mask aren't recalculated.
-		const bool active_step = pattern & 0x01;
-		pattern >>= 1;
-
-		const bool playhead_here = (step == position);
-		const bool flashing_now = playhead_here && playhead_flash_active;
-		Color color;
-		if (flashing_now) {
-			color = COLOR_BLINK;
-		} else {
-			color = (active_step) ? COLOR_ON : COLOR_OFF;
-		}
+	// Patterns store their first step in their highest bit, so reverse them to
+	// line up each step with its pixel
+	const uint16_t steps = pattern_reverse(pattern) >> (16 - length);
 
-		if (step < 8) {
-			pixel_rows[0] <<= 2;
-			pixel_rows[0] |= color;
-		} else {
-			pixel_rows[1] <<= 2;
-			pixel_rows[1] |= color;
-		}
+	uint16_t playhead = 0;
+	if (state->playhead.flash_timeout.active && (position < length)) {
+		playhead = ((uint16_t)1 << position);
+	}
 
-		step--;
-		i--;
-	} while (i);
+	// `COLOR_ON` only has its low bit set, and `COLOR_BLINK` only its high bit
+	*plane_low = steps & ~playhead;
+	*plane_high = playhead;
+}
 
-	const uint8_t row = channel * 2;
-	framebuffer_row_set(fb, row, pixel_rows[0]);
-	framebuffer_row_set(fb, row + 1, pixel_rows[1]);
+static inline uint16_t pattern_reverse(uint16_t pattern) {
+	const uint8_t low = pgm_read_byte(&BITS_REVERSED[pattern & 0xFF]);
+	const uint8_t high = pgm_read_byte(&BITS_REVERSED[pattern >> 8]);
+	return ((uint16_t)low << 8) | high;
 }
 
 static bool pattern_read(uint16_t pattern, uint8_t length, uint8_t position) {
@@ -586,11 +727,6 @@ static inline uint8_t euclid_param_get(const Params *params, Channel channel, Eu
 	return params->values[idx];
 }
 
-static inline void euclid_param_set(Params *params, Channel channel, EuclidParam kind, uint8_t val) {
-	const ParamIdx idx = euclid_param_idx(channel, kind);
-	params->values[idx] = val;
-}
-
 static inline uint8_t euclid_get_length(const Params *params, Channel channel) {
 	return euclid_param_get(params, channel, EUCLID_PARAM_LENGTH);
 }
@@ -11,6 +11,16 @@ extern "C" {
 #include "ui/framebuffer.h"
 
 #define NUM_CHANNELS 3
+#define EUCLID_NUM_PARAMS 9
+
+/// Number of preset banks stored in EEPROM
+#define EUCLID_PRESET_BANKS 4
+/// Number of presets in each bank
+#define EUCLID_PRESETS_PER_BANK 4
+/// Total number of presets, across all banks
+#define EUCLID_PRESETS_NUM (EUCLID_PRESET_BANKS * EUCLID_PRESETS_PER_BANK)
+/// Represents no preset, or no preset bank
+#define EUCLID_PRESET_NONE 0xFF
 
 typedef struct EuclidSequencerState {
 	/// Step index representing the playhead position for for each of this mode's
@@ -43,6 +53,64 @@ typedef struct EuclidPlayheadState {
 	Timeout idle_loop_timeout;
 } EuclidPlayheadState;
 
+/// Reasons that a channel needs to be redrawn, as bitflags
+typedef enum EuclidRedraw {
+	EUCLID_REDRAW_NONE = 0,
+	/// The channel's generated rhythm changed
+	EUCLID_REDRAW_PATTERN = 1 << 0,
+	/// The channel's playhead moved
+	EUCLID_REDRAW_PLAYHEAD = 1 << 1,
+	/// The playhead flash started or finished
+	EUCLID_REDRAW_FLASH = 1 << 2,
+	/// The length adjustment display was shown or hidden on the channel
+	EUCLID_REDRAW_LENGTH_DISPLAY = 1 << 3,
+} EuclidRedraw;
+
+/// A bank of presets which has been loaded from EEPROM, with its patterns
+/// generated ahead of time so that recalling a preset doesn't need to generate
+/// any patterns.
+typedef struct EuclidPresetBank {
+	/// Which bank is loaded, or `EUCLID_PRESET_NONE`
+	uint8_t bank;
+	/// Param values of each preset in the bank, indexed in the same way as `Params`
+	uint8_t values[EUCLID_PRESETS_PER_BANK][EUCLID_NUM_PARAMS];
+	/// Generated Euclidean rhythm for each preset in the bank, indexed by preset
+	/// then by channel.
+	uint16_t rhythms[EUCLID_PRESETS_PER_BANK][NUM_CHANNELS];
+} EuclidPresetBank;
+
+typedef struct EuclidPresetState {
+	EuclidPresetBank loaded;
+	/// When visible, the knobs control presets instead of params
+	bool page_visible;
+	/// Preset selected on the preset page, indexed across all banks
+	uint8_t cursor;
+	/// Preset that will be recalled on the next clock, or `EUCLID_PRESET_NONE`
+	uint8_t cued;
+	/// Preset that was most recently recalled, or `EUCLID_PRESET_NONE`
+	uint8_t recalled;
+	/// Preset that will be stored if the Offset knob is turned again before
+	/// `store_arm_timeout` fires, or `EUCLID_PRESET_NONE`
+	uint8_t store_armed;
+	Timeout store_arm_timeout;
+	/// Preset that has been stored, but not yet queued to be written to EEPROM
+	/// because the write queue was full, or `EUCLID_PRESET_NONE`
+	uint8_t store_pending;
+	/// Param values of `store_pending`, kept even if its bank is unloaded
+	uint8_t store_values[EUCLID_NUM_PARAMS];
+} EuclidPresetState;
+
+/// Param values which will replace all of the params on the next clock, such as
+/// a batch received over serial. Its patterns are generated ahead of time, like
+/// those of presets.
+typedef struct EuclidParamsCue {
+	bool cued;
+	/// Indexed in the same way as `Params`
+	uint8_t values[EUCLID_NUM_PARAMS];
+	/// Generated Euclidean rhythm for each channel
+	uint16_t rhythms[NUM_CHANNELS];
+} EuclidParamsCue;
+
 /// State of the entire Euclidean rhythm generator mode
 typedef struct EuclidState {
 	/// The sequencer channel that is currently selected
@@ -53,12 +121,38 @@ typedef struct EuclidState {
 	EuclidAdjustmentDisplayState adjustment_display;
 	EuclidOutputPulseState output_pulse;
 	EuclidPlayheadState playhead;
+	EuclidPresetState presets;
+	EuclidParamsCue params_cue;
+	/// Why each channel needs to be redrawn, as `EuclidRedraw` bitflags. Indexed
+	/// by channel number, and cleared once the channel is drawn.
+	uint8_t channels_redraw[NUM_CHANNELS];
 } EuclidState;
 
+/// Static information about each param, stored in flash. Indexed by `ParamIdx`.
+extern const ParamInfo euclid_param_infos[EUCLID_NUM_PARAMS];
+
 void euclid_params_validate(Params *params);
 void euclid_init(EuclidState *state, const Params *params, Framebuffer *fb);
+/// Generate the Euclidean rhythm for each channel, based on `params`
+/// @param rhythms Array of `NUM_CHANNELS` elements, indexed by channel.
+void euclid_rhythms_generate(uint16_t *rhythms, const Params *params);
 void euclid_update(EuclidState *state, Params *params, Framebuffer *fb, const InputEvents *events,
                    Milliseconds now);
+/// Set a single param, such as from a remote command, and regenerate its
+/// channel's rhythm. Params bounded by it are constrained to their new bounds.
+/// @return `false` if the value is out of bounds, in which case nothing is
+/// changed.
+bool euclid_param_write(EuclidState *state, Params *params, ParamIdx idx, uint8_t value);
+/// Cue `values` to replace every param on the next clock, in the same way as a
+/// cued preset, but after it.
+/// @param values Array of `EUCLID_NUM_PARAMS` elements, indexed in the same way
+/// as `Params`.
+/// @return `false` if any value is out of bounds, in which case nothing is
+/// cued.
+bool euclid_params_cue(EuclidState *state, const uint8_t *values);
+/// The earliest time at which one of the mode's timeouts will fire. Until then,
+/// `euclid_update()` only needs to be called if there are input events.
+Milliseconds euclid_next_deadline(const EuclidState *state, Milliseconds now);
 
 #ifdef __cplusplus
 }
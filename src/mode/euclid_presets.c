@@ -0,0 +1,199 @@
+#include "euclid_presets.h"
+
+#include "common/math.h"
+#include "hardware/eeprom.h"
+#include "hardware/properties.h"
+#include "logging.h"
+
+#include <string.h>
+
+/* CONSTANTS */
+
+/// EEPROM address of the first preset. Presets are stored one after the other,
+/// bank by bank, after the addresses used by the original Sebsongs firmware.
+static const Address PRESETS_ADDRESS = 16;
+
+/* DECLARATIONS */
+
+/// Read a bank from EEPROM and generate the rhythms for each of its presets
+static void presets_bank_load(EuclidPresetBank *loaded, uint8_t bank);
+/// Queue the pending stored preset to be written to EEPROM, if there is one.
+/// @return `false` if it is still pending
+static bool presets_store_flush(EuclidPresetState *presets);
+/// Store the current params into the selected preset
+/// @return `false` if a previous store is still pending, in which case nothing
+/// is stored
+static bool presets_store(EuclidState *state, const Params *params);
+static inline Address preset_address(uint8_t preset);
+static inline uint8_t preset_bank(uint8_t preset);
+static inline uint8_t preset_slot(uint8_t preset);
+
+/* EXTERNAL */
+
+void euclid_presets_page_open(EuclidPresetState *presets) {
+	presets->page_visible = true;
+	presets->store_armed = EUCLID_PRESET_NONE;
+
+	const uint8_t bank = preset_bank(presets->cursor);
+	if (presets->loaded.bank != bank) {
+		presets_bank_load(&presets->loaded, bank);
+	}
+}
+
+bool euclid_presets_update(EuclidPresetState *presets, Milliseconds now) {
+	presets_store_flush(presets);
+
+	// Early return: No store is armed, or it hasn't timed out
+	if (presets->store_armed == EUCLID_PRESET_NONE) return false;
+	if (!timeout_fired(&presets->store_arm_timeout, now)) return false;
+
+	presets->store_armed = EUCLID_PRESET_NONE;
+	return true;
+}
+
+bool euclid_presets_handle_encoder_move(EuclidState *state, const Params *params, const int16_t *enc_move,
+                                        Milliseconds now) {
+	EuclidPresetState *presets = &state->presets;
+	bool needs_redraw = false;
+
+	// Length knob moves the cursor, which crosses into the neighboring bank at
+	// either end of the current one
+	const int16_t cursor_move = enc_move[ENCODER_1];
+	if (cursor_move != 0) {
+		const int16_t cursor = presets->cursor + cursor_move;
+		presets->cursor = (uint8_t)CONSTRAIN(cursor, 0, EUCLID_PRESETS_NUM - 1);
+		presets->store_armed = EUCLID_PRESET_NONE;
+
+		const uint8_t bank = preset_bank(presets->cursor);
+		if (presets->loaded.bank != bank) {
+			// The cued preset's patterns are about to be replaced
+			presets->cued = EUCLID_PRESET_NONE;
+			presets_bank_load(&presets->loaded, bank);
+		}
+		needs_redraw = true;
+	}
+
+	// Density knob cues the selected preset
+	if (enc_move[ENCODER_2] != 0) {
+		presets->cued = presets->cursor;
+		needs_redraw = true;
+	}
+
+	// Offset knob stores the current params into the selected preset, on its
+	// second detent. A single knock of the knob only arms the store.
+	const int16_t store_move = enc_move[ENCODER_3];
+	if (store_move != 0) {
+		const bool armed = (presets->store_armed == presets->cursor) &&
+		                   !timeout_fired(&presets->store_arm_timeout, now);
+		if ((armed || ABS(store_move) >= 2) && presets_store(state, params)) {
+			presets->store_armed = EUCLID_PRESET_NONE;
+		} else {
+			presets->store_armed = presets->cursor;
+			timeout_reset(&presets->store_arm_timeout, now);
+		}
+		needs_redraw = true;
+	}
+
+	return needs_redraw;
+}
+
+bool euclid_presets_recall(EuclidState *state, Params *params) {
+	EuclidPresetState *presets = &state->presets;
+
+	// Early return: Nothing to recall
+	if (presets->cued == EUCLID_PRESET_NONE) return false;
+
+	const uint8_t slot = preset_slot(presets->cued);
+	const uint8_t *values = presets->loaded.values[slot];
+	for (ParamIdx idx = 0; idx < EUCLID_NUM_PARAMS; idx++) {
+		if (!param_and_flags_set(params, idx, values[idx])) {
+			log_param_write_suppressed();
+		}
+	}
+	memcpy(state->generated_rhythms, presets->loaded.rhythms[slot], sizeof(state->generated_rhythms));
+
+	presets->recalled = presets->cued;
+	presets->cued = EUCLID_PRESET_NONE;
+	return true;
+}
+
+void euclid_presets_draw(const EuclidPresetState *presets, Framebuffer *fb) {
+	const uint8_t bank = preset_bank(presets->cursor);
+
+	// Presets of the selected bank are shown on the left half of the row
+	uint16_t row_bits = 0;
+	for (uint8_t slot = 0; slot < EUCLID_PRESETS_PER_BANK; slot++) {
+		const uint8_t preset = (bank * EUCLID_PRESETS_PER_BANK) + slot;
+
+		Color color = COLOR_OFF;
+		if (preset == presets->cued || preset == presets->store_armed) {
+			color = COLOR_BLINK;
+		} else if (preset == presets->cursor) {
+			color = COLOR_ON;
+		} else if (preset == presets->recalled) {
+			color = COLOR_ANTS;
+		}
+		row_bits |= ((uint16_t)color << (slot * 2));
+	}
+
+	// The selected bank is shown on the right half of the row
+	row_bits |= ((uint16_t)COLOR_ON << ((EUCLID_PRESETS_PER_BANK + bank) * 2));
+
+	framebuffer_row_set(fb, LED_CH_SEL_Y, row_bits);
+}
+
+/* INTERNAL */
+
+static void presets_bank_load(EuclidPresetBank *loaded, uint8_t bank) {
+	loaded->bank = bank;
+
+	for (uint8_t slot = 0; slot < EUCLID_PRESETS_PER_BANK; slot++) {
+		const uint8_t preset = (bank * EUCLID_PRESETS_PER_BANK) + slot;
+
+		Params preset_params = {.len = EUCLID_NUM_PARAMS};
+		eeprom_block_read(preset_params.values, preset_address(preset), EUCLID_NUM_PARAMS);
+		// Presets which were never stored read as erased EEPROM, which validation
+		// replaces with default values
+		euclid_params_validate(&preset_params);
+
+		memcpy(loaded->values[slot], preset_params.values, EUCLID_NUM_PARAMS);
+		euclid_rhythms_generate(loaded->rhythms[slot], &preset_params);
+	}
+}
+
+static bool presets_store(EuclidState *state, const Params *params) {
+	EuclidPresetState *presets = &state->presets;
+
+	// Early return: Only one store can wait for the write queue at a time
+	if (!presets_store_flush(presets)) return false;
+
+	const uint8_t slot = preset_slot(presets->cursor);
+	memcpy(presets->loaded.values[slot], params->values, EUCLID_NUM_PARAMS);
+	memcpy(presets->loaded.rhythms[slot], state->generated_rhythms, sizeof(state->generated_rhythms));
+
+	memcpy(presets->store_values, params->values, EUCLID_NUM_PARAMS);
+	presets->store_pending = presets->cursor;
+	presets_store_flush(presets);
+
+	presets->recalled = presets->cursor;
+	return true;
+}
+
+static bool presets_store_flush(EuclidPresetState *presets) {
+	// Early return: Nothing pending
+	if (presets->store_pending == EUCLID_PRESET_NONE) return true;
+
+	if (!eeprom_block_write(presets->store_values, preset_address(presets->store_pending), EUCLID_NUM_PARAMS)) {
+		return false;
+	}
+	presets->store_pending = EUCLID_PRESET_NONE;
+	return true;
+}
+
+static inline Address preset_address(uint8_t preset) {
+	return PRESETS_ADDRESS + ((Address)preset * EUCLID_NUM_PARAMS);
+}
+
+static inline uint8_t preset_bank(uint8_t preset) { return preset / EUCLID_PRESETS_PER_BANK; }
+
+static inline uint8_t preset_slot(uint8_t preset) { return preset % EUCLID_PRESETS_PER_BANK; }
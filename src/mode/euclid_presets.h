@@ -0,0 +1,48 @@
+#ifndef EUCLID_PRESETS_H_
+#define EUCLID_PRESETS_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/params.h"
+#include "mode/euclid.h"
+#include "ui/framebuffer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Presets store the values of all of the Euclid mode's params in EEPROM, in
+ * banks. While the preset page is visible, the Length knob selects a preset,
+ * the Density knob cues the selected preset to be recalled on the next clock,
+ * and the Offset knob stores the current params into the selected preset.
+ * Storing overwrites a preset, so it takes two detents of the Offset knob within
+ * `PRESET_STORE_ARM_TIME`. The first arms the store, which makes the selected
+ * preset blink.
+ */
+
+/// Show the preset page, and load the selected preset's bank if needed.
+void euclid_presets_page_open(EuclidPresetState *presets);
+
+/// Retry writing a stored preset to EEPROM, if it couldn't be queued yet, and
+/// disarm a store once it times out. Must be called on every update.
+/// @return `true` if the preset page needs to be redrawn
+bool euclid_presets_update(EuclidPresetState *presets, Milliseconds now);
+
+/// Respond to knob movement while the preset page is visible.
+/// @return `true` if the preset page needs to be redrawn
+bool euclid_presets_handle_encoder_move(EuclidState *state, const Params *params, const int16_t *enc_move,
+                                        Milliseconds now);
+
+/// Replace the params and generated rhythms with those of the cued preset, if
+/// one is cued. Must be called on a clock boundary, before the sequencers read
+/// their current step.
+/// @return `true` if a preset was recalled
+bool euclid_presets_recall(EuclidState *state, Params *params);
+
+/// Draw the preset page into the channel selection row
+void euclid_presets_draw(const EuclidPresetState *presets, Framebuffer *fb);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EUCLID_PRESETS_H_ */
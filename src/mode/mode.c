@@ -2,31 +2,14 @@
 
 #include "mode/euclid.h"
 
-#if LOGGING_ENABLED
+#include <avr/pgmspace.h>
 #include <string.h>
-#endif
 
-/* CONSTANTS */
+/* DECLARATIONS */
 
-/*
-Original EEPROM Schema:
-Channel 1: length = 1 density = 2 offset = 7
-Channel 2: length = 3 density = 4 offset = 8
-Channel 3: length = 5 density = 6 offset = 9
-*/
-/// EEPROM addresses for Euclidean mode params. The order is this way for
-/// backwards-compatibility with the original Sebsongs Euclidean firmware.
-static const Address euclid_param_addresses[EUCLID_NUM_PARAMS] = {1, 2, 7, 3, 4, 8, 5, 6, 9};
-
-#if LOGGING_ENABLED
-/// Table of parameter names for logging in the Euclid mode
-static const char euclid_param_names[EUCLID_NUM_PARAMS][PARAM_NAME_LEN] = {
-    "L1", "D1", "O1", "L2", "D2", "O2", "L3", "D3", "O3",
-};
-
-/// Value that is returned if the param name is not found
-static const char name_not_found[PARAM_NAME_LEN] = "??";
-#endif
+/// Static information about the mode's params, stored in flash. Indexed by
+/// `ParamIdx`.
+static const ParamInfo *mode_param_infos(Mode mode);
 
 /* EXTERNAL */
 
@@ -47,6 +30,26 @@ void mode_update(ModeState *state, Params *params, Framebuffer *fb, Mode mode, c
 	}
 }
 
+Milliseconds mode_next_deadline(const ModeState *state, Mode mode, Milliseconds now) {
+	Milliseconds result = now;
+	switch (mode) {
+		case MODE_EUCLID:
+			result = euclid_next_deadline(&state->euclid, now);
+			break;
+	}
+	return result;
+}
+
+uint8_t mode_num_params(Mode mode) {
+	uint8_t result = 0;
+	switch (mode) {
+		case MODE_EUCLID:
+			result = EUCLID_NUM_PARAMS;
+			break;
+	}
+	return result;
+}
+
 void mode_params_validate(Params *params, Mode mode) {
 	switch (mode) {
 		case MODE_EUCLID:
@@ -55,28 +58,74 @@ void mode_params_validate(Params *params, Mode mode) {
 	}
 }
 
-Address mode_param_address(Mode mode, ParamIdx idx) {
-	Address result = 0;
+bool mode_param_write(ModeState *state, Params *params, Mode mode, ParamIdx idx, uint8_t value) {
+	// Early return: No such param
+	if (idx >= mode_num_params(mode)) return false;
+
+	bool result = false;
 	switch (mode) {
-		case MODE_EUCLID: {
-			if (idx < EUCLID_NUM_PARAMS) {
-				result = euclid_param_addresses[idx];
-			}
-		} break;
+		case MODE_EUCLID:
+			result = euclid_param_write(&state->euclid, params, idx, value);
+			break;
 	}
 	return result;
 }
 
+bool mode_params_cue(ModeState *state, Mode mode, const uint8_t *values) {
+	bool result = false;
+	switch (mode) {
+		case MODE_EUCLID:
+			result = euclid_params_cue(&state->euclid, values);
+			break;
+	}
+	return result;
+}
+
+uint8_t mode_sequencer_positions(const ModeState *state, Mode mode, uint8_t *positions) {
+	uint8_t result = 0;
+	switch (mode) {
+		case MODE_EUCLID:
+			memcpy(positions, state->euclid.sequencer.positions, NUM_CHANNELS);
+			result = NUM_CHANNELS;
+			break;
+	}
+	return result;
+}
+
+Address mode_param_address(Mode mode, ParamIdx idx) {
+	// Early return: No such param
+	if (idx >= mode_num_params(mode)) return 0;
+
+	const ParamInfo *info = &mode_param_infos(mode)[idx];
+	return (Address)pgm_read_word(&info->addr);
+}
+
+void param_info_read(ParamInfo *result, const ParamInfo *info) { memcpy_P(result, info, sizeof(*result)); }
+
 #if LOGGING_ENABLED
 void mode_param_name(char *result, Mode mode, ParamIdx idx) {
 	// Early return - null pointer
 	if (!result) return;
 
-	switch (mode) {
-		case MODE_EUCLID: {
-			const char *name_source = (idx < EUCLID_NUM_PARAMS) ? euclid_param_names[idx] : name_not_found;
-			memcpy(result, name_source, PARAM_NAME_LEN);
-		} break;
+	// Placeholder if the param name can't be found
+	if (idx >= mode_num_params(mode)) {
+		strcpy_P(result, PSTR("??"));
+		return;
 	}
+
+	const ParamInfo *info = &mode_param_infos(mode)[idx];
+	memcpy_P(result, info->name, PARAM_NAME_LEN);
 }
-#endif
\ No newline at end of file
+#endif
+
+/* INTERNAL */
+
+static const ParamInfo *mode_param_infos(Mode mode) {
+	const ParamInfo *result = euclid_param_infos;
+	switch (mode) {
+		case MODE_EUCLID:
+			result = euclid_param_infos;
+			break;
+	}
+	return result;
+}
\ No newline at end of file
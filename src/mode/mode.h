@@ -21,21 +21,34 @@ typedef enum Mode {
 void mode_init(ModeState *state, Params *params, Framebuffer *fb, Mode mode);
 void mode_update(ModeState *state, Params *params, Framebuffer *fb, Mode mode, const InputEvents *events,
                  Milliseconds now);
+/// The earliest time at which the mode needs to be updated, even if there are
+/// no input events.
+Milliseconds mode_next_deadline(const ModeState *state, Mode mode, Milliseconds now);
 
-#define EUCLID_NUM_PARAMS 9
-/// How many params this mode has. Indexed by the `Mode` enum.
-const uint8_t mode_num_params[NUM_MODES] = {
-    EUCLID_NUM_PARAMS, // EUCLID
-};
+/// How many params the mode has
+uint8_t mode_num_params(Mode mode);
 
 void mode_params_validate(Params *params, Mode mode);
 
+/// Set a single param from outside of the mode, such as from a remote command,
+/// and update the mode's state to match.
+/// @return `false` if the value is out of bounds, in which case nothing is
+/// changed.
+bool mode_param_write(ModeState *state, Params *params, Mode mode, ParamIdx idx, uint8_t value);
+/// Cue `values` to replace every param at once, on the next clock.
+/// @param values Array with an element for each of the mode's params.
+/// @return `false` if any value is out of bounds, in which case nothing is
+/// cued.
+bool mode_params_cue(ModeState *state, Mode mode, const uint8_t *values);
+/// Copy the current step of each of the mode's sequencers into `positions`.
+/// @param positions Array of at least `NUM_CHANNELS` elements.
+/// @return Number of sequencers
+uint8_t mode_sequencer_positions(const ModeState *state, Mode mode, uint8_t *positions);
+
 Address mode_param_address(Mode mode, ParamIdx idx);
 
 #if LOGGING_ENABLED
 
-#define PARAM_NAME_LEN 3
-
 /// @brief Retrieve the name for the specified parameter and store that name in
 /// the `result` null-terminated string.
 /// @param result A `char` array that can hold at least `PARAM_NAME_LEN`
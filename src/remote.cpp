@@ -0,0 +1,134 @@
+#include "remote.h"
+
+#include <Arduino.h>
+#include <serial_frame.h>
+
+/* CONSTANTS */
+
+/// Bytes in the largest response frame
+static const uint8_t RESPONSE_MAX = SERIAL_FRAME_PAYLOAD_MAX + SERIAL_FRAME_OVERHEAD;
+
+#if SERIAL_REMOTE
+
+/* GLOBALS */
+
+static SerialFrameDecoder decoder;
+
+/* DECLARATIONS */
+
+/// Run a command and send its response
+/// @return `true` if any params were written
+static bool remote_command_run(const SerialFrame *command, ModeState *state, Params *params, Mode mode);
+static void remote_respond(uint8_t code, const uint8_t *payload, uint8_t len);
+static void remote_respond_error(uint8_t command, RemoteError error);
+
+#endif
+
+/* EXTERNAL */
+
+void remote_init(void) {
+#if SERIAL_REMOTE
+	// Logging shares the serial port, and has already opened it if enabled
+#if !LOGGING_ENABLED
+	Serial.begin(SERIAL_BAUD);
+#endif
+	serial_frame_decoder_init(&decoder);
+#endif
+}
+
+bool remote_update(ModeState *state, Params *params, Mode mode) {
+#if SERIAL_REMOTE
+	bool params_written = false;
+	for (uint8_t n = 0; n < SERIAL_REMOTE_BYTES_PER_UPDATE; n++) {
+		// Leave bytes in the receive buffer until any response they complete
+		// would fit in the transmit buffer, so that sending it never waits
+		if (Serial.availableForWrite() < RESPONSE_MAX) break;
+
+		const int byte = Serial.read();
+		if (byte < 0) break;
+
+		if (serial_frame_decode(&decoder, (uint8_t)byte)) {
+			params_written |= remote_command_run(&decoder.frame, state, params, mode);
+		}
+	}
+	return params_written;
+#else
+	return false;
+#endif
+}
+
+/* INTERNAL */
+
+#if SERIAL_REMOTE
+
+static bool remote_command_run(const SerialFrame *command, ModeState *state, Params *params, Mode mode) {
+	const uint8_t *payload = command->payload;
+	const uint8_t num_params = params->len;
+	uint8_t response[SERIAL_FRAME_PAYLOAD_MAX];
+	uint8_t response_len = 0;
+	bool params_written = false;
+
+	switch (command->command) {
+		case REMOTE_COMMAND_PARAM_GET:
+			if (command->len != 1) {
+				remote_respond_error(command->command, REMOTE_ERROR_LENGTH);
+				return false;
+			}
+			if (payload[0] >= num_params) {
+				remote_respond_error(command->command, REMOTE_ERROR_OUT_OF_BOUNDS);
+				return false;
+			}
+			response[response_len++] = payload[0];
+			response[response_len++] = params->values[payload[0]];
+			break;
+		case REMOTE_COMMAND_PARAM_SET:
+			if (command->len != 2) {
+				remote_respond_error(command->command, REMOTE_ERROR_LENGTH);
+				return false;
+			}
+			if (!mode_param_write(state, params, mode, payload[0], payload[1])) {
+				remote_respond_error(command->command, REMOTE_ERROR_OUT_OF_BOUNDS);
+				return false;
+			}
+			params_written = true;
+			response[response_len++] = payload[0];
+			response[response_len++] = params->values[payload[0]];
+			break;
+		case REMOTE_COMMAND_PARAMS_GET:
+			memcpy(response, params->values, num_params);
+			response_len = num_params;
+			break;
+		case REMOTE_COMMAND_PARAMS_CUE:
+			if (command->len != num_params) {
+				remote_respond_error(command->command, REMOTE_ERROR_LENGTH);
+				return false;
+			}
+			if (!mode_params_cue(state, mode, payload)) {
+				remote_respond_error(command->command, REMOTE_ERROR_OUT_OF_BOUNDS);
+				return false;
+			}
+			break;
+		case REMOTE_COMMAND_POSITIONS_GET:
+			response_len = mode_sequencer_positions(state, mode, response);
+			break;
+		default:
+			remote_respond_error(command->command, REMOTE_ERROR_UNKNOWN_COMMAND);
+			return false;
+	}
+
+	remote_respond(command->command | REMOTE_RESPONSE_BIT, response, response_len);
+	return params_written;
+}
+
+static void remote_respond(uint8_t code, const uint8_t *payload, uint8_t len) {
+	uint8_t frame[RESPONSE_MAX];
+	const uint8_t frame_len = serial_frame_encode(frame, code, payload, len);
+	Serial.write(frame, frame_len);
+}
+
+static void remote_respond_error(uint8_t command, RemoteError error) {
+	const uint8_t payload[] = {command, (uint8_t)error};
+	remote_respond(REMOTE_RESPONSE_ERROR, payload, sizeof(payload));
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef REMOTE_H_
+#define REMOTE_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/params.h"
+#include "config.h"
+#include "mode/mode.h"
+#include "mode/state.h"
+
+#include <stdbool.h>
+
+/* The active mode can be controlled remotely over the serial port, such as by a
+ * host sequencer, using frames described in `serial_frame.h`. Each command
+ * frame is answered by a frame with the command's response code, or with
+ * `REMOTE_RESPONSE_ERROR`. Param indexes and values are single bytes, and
+ * params are indexed in the same way as `Params`.
+ *
+ * Received bytes are decoded a few at a time by a low-priority task, so remote
+ * control never holds up the clock.
+ */
+
+typedef enum RemoteCommand {
+	/// Payload: param index. Response: param index, value.
+	REMOTE_COMMAND_PARAM_GET = 0x01,
+	/// Payload: param index, value. Applied immediately. Response: param index,
+	/// value.
+	REMOTE_COMMAND_PARAM_SET = 0x02,
+	/// Payload: none. Response: every param's value.
+	REMOTE_COMMAND_PARAMS_GET = 0x03,
+	/// Payload: every param's value. Applied together on the next clock.
+	/// Response: none.
+	REMOTE_COMMAND_PARAMS_CUE = 0x04,
+	/// Payload: none. Response: the current step of each sequencer.
+	REMOTE_COMMAND_POSITIONS_GET = 0x05,
+} RemoteCommand;
+
+/// Response code of a command is the command with this bit set
+#define REMOTE_RESPONSE_BIT 0x80
+/// Response code for a command that was rejected. Payload: command,
+/// `RemoteError`.
+#define REMOTE_RESPONSE_ERROR 0xFF
+
+typedef enum RemoteError {
+	REMOTE_ERROR_UNKNOWN_COMMAND = 1,
+	/// The payload is the wrong length for the command
+	REMOTE_ERROR_LENGTH = 2,
+	/// No such param, or a value is out of bounds
+	REMOTE_ERROR_OUT_OF_BOUNDS = 3,
+} RemoteError;
+
+void remote_init(void);
+
+/// Decode received bytes, and run any commands they complete.
+/// @return `true` if any params were written
+bool remote_update(ModeState *state, Params *params, Mode mode);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* REMOTE_H_ */
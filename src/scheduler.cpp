@@ -0,0 +1,48 @@
+#include "scheduler.h"
+
+#include <Arduino.h>
+
+/* DECLARATIONS */
+
+static inline void task_record_deadline_miss(Task *task);
+
+/* EXTERNAL */
+
+void scheduler_run(Task *tasks, uint8_t num_tasks, Milliseconds now) {
+	const Microseconds pass_start = micros();
+
+	for (uint8_t idx = 0; idx < num_tasks; idx++) {
+		Task *task = &tasks[idx];
+		if (!timeout_fired(&task->release, now)) continue;
+
+		// Defer non-critical tasks that won't fit in the rest of this pass, but
+		// never twice in a row, so that they can't be starved
+		const Microseconds pass_elapsed = micros() - pass_start;
+		const bool fits = ((pass_elapsed + task->budget) <= SCHEDULER_PASS_BUDGET);
+		if (!task->critical && !task->deferred && !fits) {
+			task->deferred = true;
+			continue;
+		}
+		task->deferred = false;
+
+		const Milliseconds period = task->release.duration;
+		const bool late = (period > 0) && ((now - task->release.start) >= (period * 2));
+		timeout_reset(&task->release, now);
+
+		const Microseconds run_start = micros();
+		task->run(now);
+		const Microseconds run_time = micros() - run_start;
+
+		if (late || (run_time > task->budget)) {
+			task_record_deadline_miss(task);
+		}
+	}
+}
+
+/* INTERNAL */
+
+static inline void task_record_deadline_miss(Task *task) {
+	if (task->deadline_misses < UINT16_MAX) {
+		task->deadline_misses++;
+	}
+}
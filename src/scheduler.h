@@ -0,0 +1,42 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/timeout.h"
+#include "common/types.h"
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Performs one run of a task
+typedef void (*TaskFn)(Milliseconds now);
+
+/// A unit of work that the scheduler runs periodically. Tasks are run in the
+/// order they appear in the task table, so latency-critical tasks go first.
+typedef struct Task {
+	TaskFn run;
+	/// Duration is the task's period. A duration of `0` runs the task on every
+	/// pass of the scheduler.
+	Timeout release;
+	/// Microseconds that a single run of the task is expected to take at most
+	Microseconds budget;
+	/// Critical tasks always run when they are due. Other tasks are deferred
+	/// by one pass if their budget doesn't fit in the rest of the pass.
+	bool critical;
+	/// The task was due on the previous pass, but was deferred
+	bool deferred;
+	/// Number of runs that overran their budget, or that started more than a
+	/// whole period late. Saturates instead of overflowing.
+	uint16_t deadline_misses;
+} Task;
+
+/// Run one pass over `tasks`, running each task that is due.
+void scheduler_run(Task *tasks, uint8_t num_tasks, Milliseconds now);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SCHEDULER_H_ */
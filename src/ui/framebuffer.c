@@ -1,21 +1,35 @@
 #include "framebuffer.h"
 
+/* DECLARATIONS */
+
+/// Gather the even-numbered bits of `bits` into a byte, in order
+static inline uint8_t bits_even_gather(uint16_t bits);
+
 /* EXTERNAL */
 
 // cppcheck-suppress unusedFunction
 void framebuffer_pixel_set(Framebuffer *fb, uint8_t x, uint8_t y, Color color) {
+	const uint8_t mask = (1 << x);
+
 	// Clear existing color
-	const uint16_t mask = 0x0003; // Must be 16 bits because it gets inverted
-	fb->data[y] &= ~(mask << (x * 2));
+	fb->plane_low[y] &= ~mask;
+	fb->plane_high[y] &= ~mask;
 
 	// Set new color
-	fb->data[y] |= (color << (x * 2));
+	framebuffer_pixel_set_fast(fb, x, y, color);
+
+	fb->dirty |= (1 << y);
 }
 
 // cppcheck-suppress unusedFunction
 void framebuffer_pixel_set_fast(Framebuffer *fb, uint8_t x, uint8_t y, Color color) {
 	// Set new color
-	fb->data[y] |= (color << (x * 2));
+	if (color & 0x01) {
+		fb->plane_low[y] |= (1 << x);
+	}
+	if (color & 0x02) {
+		fb->plane_high[y] |= (1 << x);
+	}
 }
 
 // cppcheck-suppress unusedFunction
@@ -42,4 +56,23 @@ void framebuffer_pixel_off_fast(Framebuffer *fb, uint8_t x, uint8_t y) {
 void framebuffer_row_off(Framebuffer *fb, uint8_t y) { framebuffer_row_set(fb, y, 0); }
 
 // cppcheck-suppress unusedFunction
-void framebuffer_row_set(Framebuffer *fb, uint8_t y, uint16_t pixels) { fb->data[y] = pixels; }
\ No newline at end of file
+void framebuffer_row_set(Framebuffer *fb, uint8_t y, uint16_t pixels) {
+	framebuffer_row_set_planes(fb, y, bits_even_gather(pixels), bits_even_gather(pixels >> 1));
+}
+
+// cppcheck-suppress unusedFunction
+void framebuffer_row_set_planes(Framebuffer *fb, uint8_t y, uint8_t low, uint8_t high) {
+	fb->plane_low[y] = low;
+	fb->plane_high[y] = high;
+	fb->dirty |= (1 << y);
+}
+
+/* INTERNAL */
+
+static inline uint8_t bits_even_gather(uint16_t bits) {
+	bits &= 0x5555;
+	bits = (bits | (bits >> 1)) & 0x3333;
+	bits = (bits | (bits >> 2)) & 0x0F0F;
+	bits = (bits | (bits >> 4)) & 0x00FF;
+	return (uint8_t)bits;
+}
@@ -23,11 +23,20 @@ typedef enum Color {
 
 /// Buffer that can be drawn into and manipulated before being drawn to the
 /// hardware display. 2 bits per pixel, so it supports 4 colors.
+///
+/// The bits of each pixel's color are stored in two bitplanes, so that rows can
+/// be combined with animation masks using a few bitwise operations. In each
+/// plane, every row is a byte with one bit per pixel, indexed according to
+/// the pixel's x position. The rows are indexed according to their y position,
+/// from top to bottom, on the display.
 typedef struct Framebuffer {
-	/// Each row is stored as bits with 2 bits pixel, with 8 pixels per row
-	/// indexed according to their x position. The rows are indexed according to
-	/// their y position, from top to bottom, on the display.
-	uint16_t data[LED_ROWS];
+	/// Low bit of each pixel's color
+	uint8_t plane_low[LED_ROWS];
+	/// High bit of each pixel's color
+	uint8_t plane_high[LED_ROWS];
+	/// Bitflags of rows which have been drawn into since they were last copied
+	/// to the display, indexed by y position.
+	uint8_t dirty;
 } Framebuffer;
 
 void framebuffer_pixel_on(Framebuffer *fb, uint8_t x, uint8_t y);
@@ -62,6 +71,14 @@ void framebuffer_row_off(Framebuffer *fb, uint8_t y);
 /// @param y Zero-indexed position, from top to bottom.
 void framebuffer_row_set(Framebuffer *fb, uint8_t y, uint16_t pixels);
 
+/// Set the color values directly for a row of pixels on the LED Matrix, as
+/// bitplanes. Bit `x` of each plane holds a bit of the color of the pixel at
+/// that x position.
+/// @param y Zero-indexed position, from top to bottom.
+/// @param low Low bit of each pixel's color
+/// @param high High bit of each pixel's color
+void framebuffer_row_set_planes(Framebuffer *fb, uint8_t y, uint8_t low, uint8_t high);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,64 +3,155 @@
 #include "common/timeout.h"
 #include "config.h"
 #include "hardware/led.h"
+#include "logging.h"
 
-/// To keep latency from spiking, we only draw one row of the framebuffer to the
-/// LED matrix at a time. The row that gets drawn rotates between the 8 rows of
-/// the framebuffer to keep visual latency equal for all rows.
+#include <avr/pgmspace.h>
+
+/// Rows are drawn to the LED matrix one at a time. The row that gets drawn
+/// rotates between the 8 rows of the framebuffer to keep visual latency equal
+/// for all rows.
 static uint8_t out_row;
 
+/// The pixels that were last sent to each row of the LED matrix, indexed by y
+/// position. The LED matrix is cleared when it is initialized.
+static uint8_t shown_rows[LED_ROWS];
+
+/// The frame being presented on the LED matrix, as the pixels to send for each
+/// row, indexed by y position. Latched from the framebuffer all at once, so
+/// that drawing into the framebuffer mid-frame can't tear the display.
+static uint8_t frame_rows[LED_ROWS];
+/// Bitflags of rows of the presented frame which still need to be sent to the
+/// LED matrix. A new frame is latched once this is empty.
+static uint8_t frame_pending = 0x00;
+/// Bitflags of rows of the LED matrix whose pixels might not match
+/// `shown_rows`, so they need to be sent even if they look unchanged.
+static uint8_t shown_rows_stale = 0x00;
+
 #define ANIM_BLINK_NUM_FRAMES 2
 static Timeout anim_blink_timeout = {.duration = ANIM_BLINK_INTERVAL};
 static uint8_t anim_blink_frame = 0;
+/// Pixels of a row which are lit by `COLOR_BLINK` in the current frame
+static uint8_t anim_blink_mask = 0x00;
 
 #define ANIM_ANTS_NUM_FRAMES 4
 static Timeout anim_ants_timeout = {.duration = ANIM_ANTS_INTERVAL};
 static uint8_t anim_ants_frame = 0;
 
+/// The marching ants pattern repeats every 4 rows, shifting by one pixel each
+/// row. Indexed by the phase of the row, `(y - frame) % 4`.
+static const uint8_t ANIM_ANTS_PHASE_MASKS[ANIM_ANTS_NUM_FRAMES] PROGMEM = {0xCC, 0x66, 0x33, 0x99};
+/// Pixels of a row which are lit by `COLOR_ANTS` in the current frame, indexed
+/// by `y % 4`.
+static uint8_t anim_ants_masks[ANIM_ANTS_NUM_FRAMES] = {0xCC, 0x66, 0x33, 0x99};
+
 /* DECLARATIONS */
 
-static inline uint8_t anim_marching_ants(uint8_t frame, uint8_t x, uint8_t y);
+/// Calculate the pixels to send to the LED matrix for a row of the framebuffer,
+/// given the current animation frames.
+static inline uint8_t row_compose(const Framebuffer *fb, uint8_t row);
+/// Mark the rows of the framebuffer which contain `color` as dirty
+static void rows_with_color_mark_dirty(Framebuffer *fb, Color color);
+/// Latch the framebuffer's dirty rows into the presented frame, with the
+/// current animation frames, and mark the ones that changed as pending.
+static void frame_latch(Framebuffer *fb);
 
 /* EXTERNAL */
 
 // cppcheck-suppress unusedFunction
-void framebuffer_copy_row_to_display(const Framebuffer *fb) {
-	const uint8_t row = (out_row) % LED_ROWS;
-	const uint16_t row_bits = fb->data[row];
-
-	uint8_t to_draw = 0;
-	for (uint8_t col = 0; col < LED_COLUMNS; col++) {
-		Color color = (Color)((row_bits >> (col * 2)) & 0b00000011);
-
-		if (color == COLOR_ANTS) {
-			to_draw |= (anim_marching_ants(anim_ants_frame, col, row) << col);
-		} else if (color == COLOR_BLINK) {
-			to_draw |= (anim_blink_frame << col);
-		} else {
-			to_draw |= (color << col);
-		}
+bool framebuffer_copy_row_to_display(Framebuffer *fb) {
+	// Only start on a new frame once the last one has been fully shown
+	if (!frame_pending) {
+		frame_latch(fb);
+		if (!frame_pending) return false;
+		log_led_frame_begin();
+	}
+
+	// Continue from the row after the last one that was copied
+	uint8_t row = out_row;
+	while (!(frame_pending & (1 << row))) {
+		row = (row + 1) % LED_ROWS;
 	}
+	frame_pending &= ~(1 << row);
+
+	// Next time, start looking at the next row of the frame
+	out_row = (row + 1) % LED_ROWS;
 
-	led_set_row(row, to_draw);
+	led_set_row(row, frame_rows[row]);
+	shown_rows[row] = frame_rows[row];
+	shown_rows_stale &= ~(1 << row);
+	log_led_row_copy(true);
 
-	// Next cycle, copy the next row of the framebuffer to the LED matrix
-	out_row = (out_row + 1) % LED_ROWS;
+	if (!frame_pending) {
+		log_led_frame_end();
+	}
+	return true;
 }
 
 // cppcheck-suppress unusedFunction
-void framebuffer_update_color_animations(Milliseconds now) {
+void framebuffer_update_color_animations(Framebuffer *fb, Milliseconds now) {
 	if (timeout_loop(&anim_blink_timeout, now)) {
 		anim_blink_frame = (anim_blink_frame + 1) % ANIM_BLINK_NUM_FRAMES;
+		anim_blink_mask = (anim_blink_frame) ? 0xFF : 0x00;
+		rows_with_color_mark_dirty(fb, COLOR_BLINK);
 	}
 
 	if (timeout_loop(&anim_ants_timeout, now)) {
 		anim_ants_frame = (anim_ants_frame + 1) % ANIM_ANTS_NUM_FRAMES;
+		for (uint8_t row = 0; row < ANIM_ANTS_NUM_FRAMES; row++) {
+			const uint8_t phase = (row + ANIM_ANTS_NUM_FRAMES - anim_ants_frame) % ANIM_ANTS_NUM_FRAMES;
+			anim_ants_masks[row] = pgm_read_byte(&ANIM_ANTS_PHASE_MASKS[phase]);
+		}
+		rows_with_color_mark_dirty(fb, COLOR_ANTS);
 	}
 }
 
+// cppcheck-suppress unusedFunction
+void framebuffer_display_resync(Framebuffer *fb) {
+	shown_rows_stale = 0xFF;
+	fb->dirty = 0xFF;
+}
+
 /* INTERNAL */
 
-static inline uint8_t anim_marching_ants(uint8_t frame, uint8_t x, uint8_t y) {
-	const uint8_t val = (x + y + (ANIM_ANTS_NUM_FRAMES - frame)) / 2;
-	return (val % 2);
-}
\ No newline at end of file
+static inline uint8_t row_compose(const Framebuffer *fb, uint8_t row) {
+	const uint8_t low = fb->plane_low[row];
+	const uint8_t high = fb->plane_high[row];
+
+	const uint8_t on = low & ~high;
+	const uint8_t blink = high & ~low;
+	const uint8_t ants = high & low;
+
+	return on | (blink & anim_blink_mask) | (ants & anim_ants_masks[row % ANIM_ANTS_NUM_FRAMES]);
+}
+
+static void frame_latch(Framebuffer *fb) {
+	if (!fb->dirty) return;
+
+	for (uint8_t row = 0; row < LED_ROWS; row++) {
+		if (!(fb->dirty & (1 << row))) continue;
+
+		frame_rows[row] = row_compose(fb, row);
+		const bool changed = (frame_rows[row] != shown_rows[row]) || (shown_rows_stale & (1 << row));
+		if (changed) {
+			frame_pending |= (1 << row);
+		} else {
+			log_led_row_copy(false);
+		}
+	}
+
+	fb->dirty = 0x00;
+}
+
+static void rows_with_color_mark_dirty(Framebuffer *fb, Color color) {
+	for (uint8_t row = 0; row < LED_ROWS; row++) {
+		const uint8_t low = fb->plane_low[row];
+		const uint8_t high = fb->plane_high[row];
+
+		// Both animated colors have their high bit set, and only `COLOR_ANTS` has
+		// its low bit set
+		const uint8_t pixels = (color == COLOR_ANTS) ? (high & low) : (high & ~low);
+		if (pixels) {
+			fb->dirty |= (1 << row);
+		}
+	}
+}
@@ -4,16 +4,29 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+
 #include "common/types.h"
 #include "framebuffer.h"
 
-/// Copy one row of the framebuffer to the LED matrix. We only copy one row of
-/// the framebuffer to the LED matrix per cycle to avoid having to wait on the
-/// display driver chip.
-void framebuffer_copy_row_to_display(const Framebuffer *fb);
+/// Copy one changed row of the presented frame to the LED matrix. The caller
+/// decides how many rows to copy each cycle, based on how much time it has.
+///
+/// Once every row of the presented frame has been copied, the framebuffer's
+/// dirty rows are latched as the next frame, so the LED matrix never shows a
+/// mix of rows drawn before and after an update. Rows whose pixels are the same
+/// as the ones already on the display are skipped.
+/// @return `true` if a row was sent, `false` if the LED matrix is up to date.
+bool framebuffer_copy_row_to_display(Framebuffer *fb);
+
+/// Update the animations for framebuffer colors, marking rows which contain a
+/// color whose animation frame has changed as dirty.
+void framebuffer_update_color_animations(Framebuffer *fb, Milliseconds now);
 
-/// Update the animations for framebuffer colors
-void framebuffer_update_color_animations(Milliseconds now);
+/// Resend every row of the framebuffer to the LED matrix, regardless of what it
+/// is believed to show, such as after it wakes up from sleep. The rows are sent
+/// by the following calls to `framebuffer_copy_row_to_display()`.
+void framebuffer_display_resync(Framebuffer *fb);
 
 #ifdef __cplusplus
 }
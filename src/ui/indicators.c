@@ -39,6 +39,20 @@ void indicators_input_draw(Framebuffer *fb, const InputEvents *events, Milliseco
 	}
 }
 
+// cppcheck-suppress unusedFunction
+Milliseconds indicators_next_deadline(Milliseconds now) {
+	Milliseconds result = now + DEADLINE_NONE_INTERVAL;
+
+	if (trig_indicator_timeout.active) {
+		result = deadline_earliest(result, timeout_deadline(&trig_indicator_timeout.inner), now);
+	}
+	if (reset_indicator_timeout.active) {
+		result = deadline_earliest(result, timeout_deadline(&reset_indicator_timeout.inner), now);
+	}
+
+	return result;
+}
+
 // cppcheck-suppress unusedFunction
 void indicators_output_latching_draw(Framebuffer *fb, uint8_t out_channels_firing) {
 	for (uint8_t out_channel = 0; out_channel < OUTPUT_NUM_CHANNELS; out_channel++) {
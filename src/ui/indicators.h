@@ -12,6 +12,11 @@ extern "C" {
 
 void indicators_input_draw(Framebuffer *fb, const InputEvents *events, Milliseconds now);
 
+/// The earliest time at which an input indicator needs to be turned off. Until
+/// then, `indicators_input_draw()` only needs to be called if there are input
+/// events.
+Milliseconds indicators_next_deadline(Milliseconds now);
+
 /// Draw output indicators for latching outputs - ones that stay lit until they
 /// are specifically unlit on the next clock cycle.
 /// @param out_channels_firing Bitflags storing which output channels will fire
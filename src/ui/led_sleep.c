@@ -39,7 +39,9 @@ void led_sleep_init(Milliseconds now) {
 }
 
 // cppcheck-suppress unusedFunction
-void led_sleep_update(bool postpone_sleep, Milliseconds now) {
+bool led_sleep_update(bool postpone_sleep, Milliseconds now) {
+	const bool was_asleep = (state == LED_SLEEP_STATE_SLEEP);
+
 	const LedSleepUpdate sleep_update = led_sleep_decide(postpone_sleep, now);
 	if (sleep_update == LED_SLEEP_UPDATE_WAKE) {
 		led_wake();
@@ -48,6 +50,13 @@ void led_sleep_update(bool postpone_sleep, Milliseconds now) {
 	} else if (sleep_update == LED_SLEEP_UPDATE_SLEEP) {
 		led_sleep();
 	}
+
+	return was_asleep && (sleep_update == LED_SLEEP_UPDATE_WAKE);
+}
+
+// cppcheck-suppress unusedFunction
+bool led_sleep_asleep(void) {
+	return state == LED_SLEEP_STATE_SLEEP;
 }
 
 /* INTERNAL */
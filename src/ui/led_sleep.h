@@ -9,7 +9,12 @@ extern "C" {
 #include "common/types.h"
 
 void led_sleep_init(Milliseconds now);
-void led_sleep_update(bool postpone_sleep, Milliseconds now);
+/// @return `true` if the LED matrix was woken up from sleep, and needs to be
+/// resynced with the framebuffer.
+bool led_sleep_update(bool postpone_sleep, Milliseconds now);
+/// Is the LED matrix asleep? While asleep, nothing needs to be rendered or sent
+/// to it.
+bool led_sleep_asleep(void);
 
 #ifdef __cplusplus
 }
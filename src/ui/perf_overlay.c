@@ -0,0 +1,111 @@
+#include "perf_overlay.h"
+
+#include "common/timeout.h"
+#include "config.h"
+#include "hardware/properties.h"
+#include "logging.h"
+
+#include <avr/pgmspace.h>
+
+#if PERF_OVERLAY
+
+/* CONSTANTS */
+
+#define LOAD_BAR_PIXELS 4
+#define LOAD_BAR_X 0
+/// Cycle time which lights the first pixel of the load bar
+static const Microseconds LOAD_BAR_BASE = 250;
+
+#define LATENCY_PIXELS 3
+#define LATENCY_X 4
+/// Upper bound of each latency bucket. Latencies beyond the last one light every pixel.
+static const Microseconds LATENCY_BUCKETS[LATENCY_PIXELS - 1] PROGMEM = {500, 1000};
+
+#define DEADLINE_MISS_X 7
+
+/* GLOBALS */
+
+static Timeout redraw_timeout = {.duration = PERF_OVERLAY_INTERVAL};
+
+static Microseconds trig_latency_max;
+static bool trig_seen = false;
+
+static uint16_t deadline_misses_previous;
+
+/* DECLARATIONS */
+
+static uint8_t load_bar_pixels(Microseconds cycle_time);
+static uint8_t latency_pixels(void);
+static uint16_t deadline_misses_total(const Task *tasks, uint8_t num_tasks);
+
+#endif
+
+/* EXTERNAL */
+
+// cppcheck-suppress unusedFunction
+void perf_overlay_record_trig_latency(Microseconds latency) {
+#if PERF_OVERLAY
+	if (latency > trig_latency_max) {
+		trig_latency_max = latency;
+	}
+	trig_seen = true;
+#endif
+}
+
+// cppcheck-suppress unusedFunction
+void perf_overlay_update(Framebuffer *fb, const Task *tasks, uint8_t num_tasks, Milliseconds now) {
+#if PERF_OVERLAY
+	if (!timeout_loop(&redraw_timeout, now)) return;
+
+	uint8_t row = load_bar_pixels(log_cycle_time_recent_max());
+	row |= latency_pixels();
+
+	const uint16_t deadline_misses = deadline_misses_total(tasks, num_tasks);
+	if (deadline_misses != deadline_misses_previous) {
+		row |= (1 << DEADLINE_MISS_X);
+		deadline_misses_previous = deadline_misses;
+	}
+
+	framebuffer_row_set_planes(fb, LED_CH_SEL_Y, row, 0x00);
+#endif
+}
+
+/* INTERNAL */
+
+#if PERF_OVERLAY
+
+static uint8_t load_bar_pixels(Microseconds cycle_time) {
+	uint8_t pixels = 0;
+	Microseconds threshold = LOAD_BAR_BASE;
+	for (uint8_t x = LOAD_BAR_X; x < LOAD_BAR_X + LOAD_BAR_PIXELS; x++) {
+		if (cycle_time < threshold) break;
+		pixels |= (1 << x);
+		threshold <<= 1;
+	}
+	return pixels;
+}
+
+static uint8_t latency_pixels(void) {
+	if (!trig_seen) return 0;
+
+	uint8_t bucket = 0;
+	while (bucket < LATENCY_PIXELS - 1 && trig_latency_max >= pgm_read_dword(&LATENCY_BUCKETS[bucket])) {
+		bucket++;
+	}
+	trig_latency_max = 0;
+	trig_seen = false;
+
+	// Light one pixel for the first bucket, and one more for each bucket after it
+	const uint8_t lit = (1 << (bucket + 1)) - 1;
+	return lit << LATENCY_X;
+}
+
+static uint16_t deadline_misses_total(const Task *tasks, uint8_t num_tasks) {
+	uint16_t total = 0;
+	for (uint8_t i = 0; i < num_tasks; i++) {
+		total += tasks[i].deadline_misses;
+	}
+	return total;
+}
+
+#endif
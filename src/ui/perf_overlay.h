@@ -0,0 +1,34 @@
+#ifndef PERF_OVERLAY_H_
+#define PERF_OVERLAY_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/types.h"
+#include "framebuffer.h"
+#include "scheduler.h"
+
+#include <stdint.h>
+
+/* The performance overlay takes over the channel select row of the LED matrix
+ * to show timing without a serial connection. Only active when `PERF_OVERLAY`
+ * is enabled. From left to right, the row shows:
+ * - x 0-3: Load bar of the longest cycle time, where each pixel doubles the
+ *   time, starting from 250us
+ * - x 4-6: Bucket of the longest trig to output latency, where more pixels is
+ *   longer, or nothing if no trigs were received
+ * - x 7: Lit if any task missed a deadline
+ * Each reading covers the time since the last redraw of the overlay.
+ */
+
+/// Note the time between a trig being read and the sequencer setting its
+/// outputs in response.
+void perf_overlay_record_trig_latency(Microseconds latency);
+
+/// Periodically redraw the overlay from the latest measurements.
+void perf_overlay_update(Framebuffer *fb, const Task *tasks, uint8_t num_tasks, Milliseconds now);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PERF_OVERLAY_H_ */
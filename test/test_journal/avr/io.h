@@ -0,0 +1,11 @@
+#ifndef AVR_IO_H_
+#define AVR_IO_H_
+
+/* Host stand-in for the ATmega328P's <avr/io.h>, with only what the journal
+ * needs.
+ */
+
+/// Last EEPROM address
+#define E2END 0x3FF
+
+#endif /* AVR_IO_H_ */
@@ -0,0 +1,191 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "config.h"
+// Test the journal even if it is disabled in the firmware. `config.h` is
+// include guarded, so these stay in effect for the journal.
+#undef EEPROM_READ
+#define EEPROM_READ 1
+#undef EEPROM_WRITE
+#define EEPROM_WRITE 1
+#undef EEPROM_JOURNAL
+#define EEPROM_JOURNAL 1
+
+#include "hardware/eeprom_journal.c"
+
+/* EEPROM STUB */
+
+/// Writes are programmed as soon as they are queued
+static uint8_t eeprom[E2END + 1];
+/// Number of times each address was programmed
+static uint16_t eeprom_writes[E2END + 1];
+static uint8_t queue_free;
+/// Writes which are programmed before the power is cut, after which writes
+/// are lost. Negative if the power stays on.
+static int writes_until_power_cut;
+
+bool eeprom_queue_write(Address addr, uint8_t value) {
+    if (writes_until_power_cut == 0) return true;
+    if (writes_until_power_cut > 0) writes_until_power_cut--;
+
+    eeprom[addr] = value;
+    eeprom_writes[addr]++;
+    return true;
+}
+
+uint8_t eeprom_queue_read(Address addr) { return eeprom[addr]; }
+
+uint8_t eeprom_queue_free(void) { return queue_free; }
+
+/* HELPERS */
+
+/// Load the journal as when booting, which also finds where to append next
+static bool journal_boot(uint8_t *values) {
+    return eeprom_journal_load(values, PARAMS_MAX);
+}
+
+static void values_fill(uint8_t *values, uint8_t first) {
+    for (uint8_t i = 0; i < PARAMS_MAX; i++) {
+        values[i] = first + i;
+    }
+}
+
+void setUp(void) {
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    memset(eeprom_writes, 0, sizeof(eeprom_writes));
+    queue_free = EEPROM_QUEUE_LEN;
+    writes_until_power_cut = -1;
+
+    uint8_t values[PARAMS_MAX];
+    journal_boot(values);
+}
+
+// required on Windows
+void tearDown(void) { }
+
+/* TESTS */
+
+void test_journal_erased(void) {
+    uint8_t values[PARAMS_MAX];
+    TEST_ASSERT_FALSE(journal_boot(values));
+
+    uint8_t appended[PARAMS_MAX];
+    values_fill(appended, 1);
+    TEST_ASSERT_EQUAL(JOURNAL_ADDRESS + RECORD_VALUES_OFFSET, eeprom_journal_append(appended, PARAMS_MAX));
+
+    TEST_ASSERT_TRUE(journal_boot(values));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(appended, values, PARAMS_MAX);
+}
+
+void test_journal_queue_full(void) {
+    uint8_t appended[PARAMS_MAX];
+    values_fill(appended, 1);
+    queue_free = RECORD_LEN - 1;
+    TEST_ASSERT_EQUAL(0, eeprom_journal_append(appended, PARAMS_MAX));
+
+    uint8_t values[PARAMS_MAX];
+    TEST_ASSERT_FALSE(journal_boot(values));
+}
+
+/// The newest record is loaded after every append, and appends are spread
+/// evenly across the journal
+void test_journal_append_many(void) {
+    uint8_t appended[PARAMS_MAX];
+    uint8_t values[PARAMS_MAX];
+    for (uint8_t n = 0; n < 200; n++) {
+        values_fill(appended, n);
+        TEST_ASSERT_TRUE(eeprom_journal_append(appended, PARAMS_MAX) != 0);
+
+        TEST_ASSERT_TRUE(journal_boot(values));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(appended, values, PARAMS_MAX);
+    }
+
+    const uint16_t max_writes = (200 + JOURNAL_SLOTS - 1) / JOURNAL_SLOTS;
+    for (Address addr = 0; addr <= E2END; addr++) {
+        TEST_ASSERT_TRUE(eeprom_writes[addr] <= max_writes);
+    }
+}
+
+/// A record that was only partly written when the power was cut is skipped
+void test_journal_torn_record(void) {
+    uint8_t first[PARAMS_MAX];
+    values_fill(first, 1);
+    eeprom_journal_append(first, PARAMS_MAX);
+
+    uint8_t second[PARAMS_MAX];
+    values_fill(second, 100);
+    writes_until_power_cut = RECORD_LEN / 2;
+    eeprom_journal_append(second, PARAMS_MAX);
+    writes_until_power_cut = -1;
+
+    uint8_t values[PARAMS_MAX];
+    TEST_ASSERT_TRUE(journal_boot(values));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(first, values, PARAMS_MAX);
+
+    // Appending carries on after the torn record
+    uint8_t third[PARAMS_MAX];
+    values_fill(third, 50);
+    TEST_ASSERT_EQUAL(slot_address(2) + RECORD_VALUES_OFFSET, eeprom_journal_append(third, PARAMS_MAX));
+    TEST_ASSERT_TRUE(journal_boot(values));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(third, values, PARAMS_MAX);
+}
+
+/// A torn record that overwrote the oldest record, after the journal wrapped
+/// around, is skipped in favour of the one before it
+void test_journal_torn_record_wrapped(void) {
+    uint8_t appended[PARAMS_MAX];
+    for (uint8_t n = 0; n < JOURNAL_SLOTS; n++) {
+        values_fill(appended, n);
+        eeprom_journal_append(appended, PARAMS_MAX);
+    }
+
+    uint8_t torn[PARAMS_MAX];
+    values_fill(torn, 200);
+    writes_until_power_cut = RECORD_LEN - 1;
+    eeprom_journal_append(torn, PARAMS_MAX);
+    writes_until_power_cut = -1;
+
+    uint8_t values[PARAMS_MAX];
+    TEST_ASSERT_TRUE(journal_boot(values));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(appended, values, PARAMS_MAX);
+}
+
+/// The sequence number wraps around past the one that erased slots have, and
+/// records after the wrap are still newer
+void test_journal_seq_wrap(void) {
+    uint8_t record[RECORD_LEN];
+    record[RECORD_SEQ_OFFSET] = 0xFE;
+    record[RECORD_SEQ_OFFSET + 1] = 0xFF;
+    values_fill(&record[RECORD_VALUES_OFFSET], 1);
+    record[RECORD_CRC_OFFSET] = record_crc(record);
+    memcpy(&eeprom[slot_address(0)], record, RECORD_LEN);
+
+    uint8_t values[PARAMS_MAX];
+    TEST_ASSERT_TRUE(journal_boot(values));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&record[RECORD_VALUES_OFFSET], values, PARAMS_MAX);
+
+    uint8_t appended[PARAMS_MAX];
+    for (uint8_t n = 0; n < 2; n++) {
+        values_fill(appended, 10 * (n + 1));
+        eeprom_journal_append(appended, PARAMS_MAX);
+
+        TEST_ASSERT_TRUE(journal_boot(values));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(appended, values, PARAMS_MAX);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, record_seq_read(1));
+    TEST_ASSERT_EQUAL_UINT16(1, record_seq_read(2));
+}
+
+int main( int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_journal_erased);
+    RUN_TEST(test_journal_queue_full);
+    RUN_TEST(test_journal_append_many);
+    RUN_TEST(test_journal_torn_record);
+    RUN_TEST(test_journal_torn_record_wrapped);
+    RUN_TEST(test_journal_seq_wrap);
+
+    UNITY_END();
+}
@@ -0,0 +1,19 @@
+#ifndef UTIL_CRC16_H_
+#define UTIL_CRC16_H_
+
+#include <stdint.h>
+
+/* Host stand-in for avr-libc's <util/crc16.h>, with only what the journal
+ * needs.
+ */
+
+/// CRC-8 with the polynomial 0x07, as in avr-libc
+static inline uint8_t _crc8_ccitt_update(uint8_t crc, uint8_t data) {
+    crc ^= data;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+#endif /* UTIL_CRC16_H_ */
@@ -0,0 +1,205 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "common/params.c"
+
+/* STUBS */
+
+/// Tables are in RAM on the host
+void param_info_read(ParamInfo *result, const ParamInfo *info) { memcpy(result, info, sizeof(*result)); }
+
+/* HELPERS */
+
+#define TEST_NUM_PARAMS 4
+
+/// A length, with a density bounded by it and an offset bounded by one less
+/// than it, then an unrelated param
+static const ParamInfo infos[TEST_NUM_PARAMS] = {
+    {.addr = 1, .min = 1, .max = 16, .default_value = 16, .bound_by = PARAM_IDX_NONE, .bound_margin = 0, .name = "L"},
+    {.addr = 2, .min = 0, .max = 16, .default_value = 4, .bound_by = 0, .bound_margin = 0, .name = "D"},
+    {.addr = 3, .min = 0, .max = 15, .default_value = 0, .bound_by = 0, .bound_margin = 1, .name = "O"},
+    {.addr = 4, .min = 2, .max = 10, .default_value = 5, .bound_by = PARAM_IDX_NONE, .bound_margin = 0, .name = "X"},
+};
+
+static Params params;
+
+static void params_set(uint8_t length, uint8_t density, uint8_t offset, uint8_t other) {
+    params.values[0] = length;
+    params.values[1] = density;
+    params.values[2] = offset;
+    params.values[3] = other;
+}
+
+void setUp(void) {
+    memset(&params, 0, sizeof(params));
+    params.len = TEST_NUM_PARAMS;
+    params_set(8, 4, 2, 5);
+}
+
+// required on Windows
+void tearDown(void) { }
+
+/* TESTS */
+
+void test_params_bits_fit(void) {
+    TEST_ASSERT_TRUE(sizeof(ParamBits) * 8 >= PARAMS_MAX);
+}
+
+void test_params_flags_set_clear(void) {
+    param_flags_set(&params, 3, PARAM_FLAG_MODIFIED);
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAG_MODIFIED, param_flags_get(&params, 3, PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE));
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAGS_NONE, param_flags_get(&params, 2, PARAM_FLAG_MODIFIED));
+
+    param_flags_set(&params, 3, PARAM_FLAG_NEEDS_WRITE);
+    param_flags_clear(&params, 3, PARAM_FLAG_MODIFIED);
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAG_NEEDS_WRITE, param_flags_get(&params, 3, PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE));
+    TEST_ASSERT_EQUAL_UINT16(0, params.modified);
+    TEST_ASSERT_EQUAL_UINT16(1 << 3, params.needs_write);
+}
+
+/// The last param of the largest mode has its own bit
+void test_params_flags_last_param(void) {
+    params.len = PARAMS_MAX;
+    param_flags_set(&params, PARAMS_MAX - 1, PARAM_FLAG_MODIFIED);
+    TEST_ASSERT_EQUAL_UINT16(1 << (PARAMS_MAX - 1), params.modified);
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAGS_NONE, param_flags_get(&params, 0, PARAM_FLAG_MODIFIED));
+}
+
+void test_params_flags_any(void) {
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAGS_NONE, params_flags_any(&params, PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE));
+
+    param_flags_set(&params, 1, PARAM_FLAG_NEEDS_WRITE);
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAGS_NONE, params_flags_any(&params, PARAM_FLAG_MODIFIED));
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAG_NEEDS_WRITE, params_flags_any(&params, PARAM_FLAG_NEEDS_WRITE));
+
+    params_flags_clear_all(&params, PARAM_FLAG_NEEDS_WRITE);
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAGS_NONE, params_flags_any(&params, PARAM_FLAG_NEEDS_WRITE));
+}
+
+void test_params_flags_bits(void) {
+    param_flags_set(&params, 0, PARAM_FLAG_MODIFIED);
+    param_flags_set(&params, 2, PARAM_FLAG_NEEDS_WRITE);
+    TEST_ASSERT_EQUAL_UINT16(0x1, params_flags_bits(&params, PARAM_FLAG_MODIFIED));
+    TEST_ASSERT_EQUAL_UINT16(0x5, params_flags_bits(&params, PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE));
+}
+
+/// Params in a set are visited from the lowest index up
+void test_params_bits_iteration_order(void) {
+    const ParamIdx expected[] = {0, 3, 5, PARAMS_MAX - 1};
+    ParamBits bits = 0;
+    for (uint8_t i = 0; i < sizeof(expected); i++) {
+        bits |= (ParamBits)1 << expected[i];
+    }
+
+    uint8_t visited = 0;
+    for (; bits; bits &= bits - 1) {
+        TEST_ASSERT_EQUAL_UINT8(expected[visited], param_bits_first(bits));
+        visited++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(sizeof(expected), visited);
+}
+
+void test_params_set_flags(void) {
+    TEST_ASSERT_TRUE(param_and_flags_set(&params, 3, 7));
+    TEST_ASSERT_EQUAL_UINT8(7, params.values[3]);
+    TEST_ASSERT_EQUAL_UINT8(PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE,
+                            param_flags_get(&params, 3, PARAM_FLAG_MODIFIED | PARAM_FLAG_NEEDS_WRITE));
+}
+
+/// Writing the value a param already has changes nothing
+void test_params_set_unchanged(void) {
+    TEST_ASSERT_FALSE(param_and_flags_set(&params, 3, 5));
+    TEST_ASSERT_EQUAL_UINT16(0, params.modified);
+    TEST_ASSERT_EQUAL_UINT16(0, params.needs_write);
+}
+
+void test_params_validate_in_bounds(void) {
+    params_set(16, 16, 15, 10);
+    params_validate(&params, infos);
+    const uint8_t expected[] = {16, 16, 15, 10};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, params.values, TEST_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT16(0, params.modified);
+}
+
+/// Out of bounds params get their default, constrained by the params bounding
+/// them
+void test_params_validate_defaults(void) {
+    params_set(0xFF, 0xFF, 0xFF, 1);
+    params_validate(&params, infos);
+    const uint8_t expected[] = {16, 4, 0, 5};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, params.values, TEST_NUM_PARAMS);
+
+    params_set(3, 9, 3, 11);
+    params_validate(&params, infos);
+    const uint8_t bounded[] = {3, 3, 0, 5};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bounded, params.values, TEST_NUM_PARAMS);
+}
+
+/// `bound_margin` is subtracted from the bounding param
+void test_params_validate_margin(void) {
+    params_set(5, 5, 4, 5);
+    params_validate(&params, infos);
+    TEST_ASSERT_EQUAL_UINT8(4, params.values[2]);
+
+    params_set(5, 5, 5, 5);
+    params_validate(&params, infos);
+    TEST_ASSERT_EQUAL_UINT8(0, params.values[2]);
+}
+
+void test_params_adjust_clamps(void) {
+    TEST_ASSERT_TRUE(param_adjust(&params, infos, 3, 100));
+    TEST_ASSERT_EQUAL_UINT8(10, params.values[3]);
+    TEST_ASSERT_TRUE(param_adjust(&params, infos, 3, -100));
+    TEST_ASSERT_EQUAL_UINT8(2, params.values[3]);
+
+    // Already at the limit, so nothing changes
+    params.modified = 0;
+    TEST_ASSERT_FALSE(param_adjust(&params, infos, 3, -1));
+    TEST_ASSERT_EQUAL_UINT16(0, params.modified);
+}
+
+/// A param can't be adjusted past the bound set by another param
+void test_params_adjust_bounded(void) {
+    TEST_ASSERT_TRUE(param_adjust(&params, infos, 1, 10));
+    TEST_ASSERT_EQUAL_UINT8(8, params.values[1]);
+    TEST_ASSERT_TRUE(param_adjust(&params, infos, 2, 10));
+    TEST_ASSERT_EQUAL_UINT8(7, params.values[2]);
+}
+
+/// Reducing a bounding param pulls the params it bounds down with it, and
+/// flags them too
+void test_params_adjust_dependents(void) {
+    params_set(8, 8, 7, 5);
+    TEST_ASSERT_TRUE(param_adjust(&params, infos, 0, -3));
+    const uint8_t expected[] = {5, 5, 4, 5};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, params.values, TEST_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT16(0x7, params.modified);
+
+    // Increasing it leaves them be
+    params.modified = 0;
+    TEST_ASSERT_TRUE(param_adjust(&params, infos, 0, 3));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(((const uint8_t[]){8, 5, 4, 5}), params.values, TEST_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT16(0x1, params.modified);
+}
+
+int main( int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_params_bits_fit);
+    RUN_TEST(test_params_flags_set_clear);
+    RUN_TEST(test_params_flags_last_param);
+    RUN_TEST(test_params_flags_any);
+    RUN_TEST(test_params_flags_bits);
+    RUN_TEST(test_params_bits_iteration_order);
+    RUN_TEST(test_params_set_flags);
+    RUN_TEST(test_params_set_unchanged);
+    RUN_TEST(test_params_validate_in_bounds);
+    RUN_TEST(test_params_validate_defaults);
+    RUN_TEST(test_params_validate_margin);
+    RUN_TEST(test_params_adjust_clamps);
+    RUN_TEST(test_params_adjust_bounded);
+    RUN_TEST(test_params_adjust_dependents);
+
+    UNITY_END();
+}
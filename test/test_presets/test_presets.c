@@ -0,0 +1,216 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "common/timeout.c"
+#include "mode/euclid_presets.c"
+
+/* STUBS */
+
+/// Size of the ATmega328P's EEPROM
+#define EEPROM_LEN 1024
+
+static uint8_t eeprom[EEPROM_LEN];
+/// Whether the EEPROM write queue has room for a block
+static bool queue_has_room;
+static uint16_t drawn_row;
+
+void eeprom_block_read(uint8_t *values, Address addr, uint8_t len) { memcpy(values, &eeprom[addr], len); }
+
+bool eeprom_block_write(const uint8_t *values, Address addr, uint8_t len) {
+    if (!queue_has_room) return false;
+    memcpy(&eeprom[addr], values, len);
+    return true;
+}
+
+/// Erased bytes are out of bounds, and replaced with a default
+void euclid_params_validate(Params *params) {
+    for (ParamIdx idx = 0; idx < params->len; idx++) {
+        if (params->values[idx] > 16) params->values[idx] = 4;
+    }
+}
+
+/// Each channel's rhythm is stood in for by its first param
+void euclid_rhythms_generate(uint16_t *rhythms, const Params *params) {
+    for (uint8_t c = 0; c < NUM_CHANNELS; c++) {
+        rhythms[c] = params->values[c * 3];
+    }
+}
+
+bool param_and_flags_set(Params *params, ParamIdx idx, uint8_t value) {
+    const bool changed = params->values[idx] != value;
+    params->values[idx] = value;
+    return changed;
+}
+
+void log_param_write_suppressed() { }
+
+void framebuffer_row_set(Framebuffer *fb, uint8_t y, uint16_t pixels) { drawn_row = pixels; }
+
+/* HELPERS */
+
+static EuclidState state;
+static Params params;
+
+/// Move one knob on the preset page
+static bool knob_move(EncoderIdx enc_idx, int16_t move, Milliseconds now) {
+    int16_t enc_move[NUM_ENCODERS] = {0};
+    enc_move[enc_idx] = move;
+    return euclid_presets_handle_encoder_move(&state, &params, enc_move, now);
+}
+
+static const uint8_t *preset_stored(uint8_t preset) { return &eeprom[preset_address(preset)]; }
+
+/// Color that the preset page shows a preset of the selected bank in
+static Color preset_color(uint8_t preset) {
+    euclid_presets_draw(&state.presets, NULL);
+    return (Color)((drawn_row >> (preset_slot(preset) * 2)) & 0x3);
+}
+
+void setUp(void) {
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    queue_has_room = true;
+
+    memset(&state, 0, sizeof(state));
+    state.presets.loaded.bank = EUCLID_PRESET_NONE;
+    state.presets.cued = EUCLID_PRESET_NONE;
+    state.presets.recalled = EUCLID_PRESET_NONE;
+    state.presets.store_armed = EUCLID_PRESET_NONE;
+    state.presets.store_arm_timeout.duration = PRESET_STORE_ARM_TIME;
+    state.presets.store_pending = EUCLID_PRESET_NONE;
+
+    memset(&params, 0, sizeof(params));
+    params.len = EUCLID_NUM_PARAMS;
+    for (ParamIdx idx = 0; idx < EUCLID_NUM_PARAMS; idx++) {
+        params.values[idx] = idx + 1;
+    }
+
+    euclid_presets_page_open(&state.presets);
+}
+
+// required on Windows
+void tearDown(void) { }
+
+/* TESTS */
+
+void test_presets_erased_load_defaults(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.loaded.bank);
+    TEST_ASSERT_EQUAL_UINT8(4, state.presets.loaded.values[0][0]);
+}
+
+/// A single detent of the Offset knob only arms the store
+void test_presets_store_single_detent(void) {
+    TEST_ASSERT_TRUE(knob_move(ENCODER_3, 1, 1000));
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.store_armed);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, preset_stored(0)[0]);
+    TEST_ASSERT_EQUAL(COLOR_BLINK, preset_color(0));
+}
+
+void test_presets_store_second_detent(void) {
+    knob_move(ENCODER_3, 1, 1000);
+    knob_move(ENCODER_3, -1, 1000 + PRESET_STORE_ARM_TIME - 1);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(params.values, preset_stored(0), EUCLID_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(params.values, state.presets.loaded.values[0], EUCLID_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT8(EUCLID_PRESET_NONE, state.presets.store_armed);
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.recalled);
+}
+
+/// Two detents reported at once are as deliberate as two in a row
+void test_presets_store_two_detents_at_once(void) {
+    knob_move(ENCODER_3, 2, 1000);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(params.values, preset_stored(0), EUCLID_NUM_PARAMS);
+}
+
+/// Once the store has timed out, the next detent arms it again instead
+void test_presets_store_timed_out(void) {
+    knob_move(ENCODER_3, 1, 1000);
+    TEST_ASSERT_TRUE(euclid_presets_update(&state.presets, 1000 + PRESET_STORE_ARM_TIME));
+    TEST_ASSERT_EQUAL_UINT8(EUCLID_PRESET_NONE, state.presets.store_armed);
+    TEST_ASSERT_FALSE(euclid_presets_update(&state.presets, 1000 + PRESET_STORE_ARM_TIME + 1));
+
+    knob_move(ENCODER_3, 1, 1000 + PRESET_STORE_ARM_TIME + 1);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, preset_stored(0)[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.store_armed);
+}
+
+/// Selecting another preset disarms the store, so it can't overwrite a preset
+/// that wasn't selected when it was armed
+void test_presets_store_cursor_moved(void) {
+    knob_move(ENCODER_3, 1, 1000);
+    knob_move(ENCODER_1, 1, 1001);
+    TEST_ASSERT_EQUAL_UINT8(EUCLID_PRESET_NONE, state.presets.store_armed);
+
+    knob_move(ENCODER_3, 1, 1002);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, preset_stored(0)[0]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, preset_stored(1)[0]);
+}
+
+/// A store that doesn't fit in the write queue is retried, even after moving
+/// to another bank, and blocks other stores until then
+void test_presets_store_queue_full(void) {
+    queue_has_room = false;
+    knob_move(ENCODER_3, 2, 1000);
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.store_pending);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, preset_stored(0)[0]);
+
+    knob_move(ENCODER_1, EUCLID_PRESETS_PER_BANK, 1001);
+    uint8_t stored[EUCLID_NUM_PARAMS];
+    memcpy(stored, params.values, EUCLID_NUM_PARAMS);
+    params.values[0] = 16;
+    knob_move(ENCODER_3, 2, 1002);
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.store_pending);
+
+    queue_has_room = true;
+    euclid_presets_update(&state.presets, 1003);
+    TEST_ASSERT_EQUAL_UINT8(EUCLID_PRESET_NONE, state.presets.store_pending);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(stored, preset_stored(0), EUCLID_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, preset_stored(EUCLID_PRESETS_PER_BANK)[0]);
+}
+
+void test_presets_recall(void) {
+    // A stored preset keeps the patterns that were generated for its params
+    const uint16_t rhythms[NUM_CHANNELS] = {0x1111, 0x2222, 0x3333};
+    memcpy(state.generated_rhythms, rhythms, sizeof(rhythms));
+    knob_move(ENCODER_3, 2, 1000);
+    const uint8_t stored[EUCLID_NUM_PARAMS] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    memset(params.values, 0, EUCLID_NUM_PARAMS);
+    memset(state.generated_rhythms, 0, sizeof(state.generated_rhythms));
+
+    // Nothing is recalled until a preset is cued
+    TEST_ASSERT_FALSE(euclid_presets_recall(&state, &params));
+
+    knob_move(ENCODER_2, 1, 1001);
+    TEST_ASSERT_EQUAL(COLOR_BLINK, preset_color(0));
+    TEST_ASSERT_TRUE(euclid_presets_recall(&state, &params));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(stored, params.values, EUCLID_NUM_PARAMS);
+    TEST_ASSERT_EQUAL_UINT16(0x1111, state.generated_rhythms[0]);
+    TEST_ASSERT_EQUAL_UINT16(0x3333, state.generated_rhythms[2]);
+    TEST_ASSERT_EQUAL_UINT8(EUCLID_PRESET_NONE, state.presets.cued);
+    TEST_ASSERT_EQUAL_UINT8(0, state.presets.recalled);
+}
+
+/// Moving to another bank replaces the loaded patterns, so the cue is dropped
+void test_presets_cue_bank_change(void) {
+    knob_move(ENCODER_2, 1, 1000);
+    knob_move(ENCODER_1, EUCLID_PRESETS_PER_BANK, 1001);
+    TEST_ASSERT_EQUAL_UINT8(1, state.presets.loaded.bank);
+    TEST_ASSERT_EQUAL_UINT8(EUCLID_PRESET_NONE, state.presets.cued);
+    TEST_ASSERT_FALSE(euclid_presets_recall(&state, &params));
+}
+
+int main( int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_presets_erased_load_defaults);
+    RUN_TEST(test_presets_store_single_detent);
+    RUN_TEST(test_presets_store_second_detent);
+    RUN_TEST(test_presets_store_two_detents_at_once);
+    RUN_TEST(test_presets_store_timed_out);
+    RUN_TEST(test_presets_store_cursor_moved);
+    RUN_TEST(test_presets_store_queue_full);
+    RUN_TEST(test_presets_recall);
+    RUN_TEST(test_presets_cue_bank_change);
+
+    UNITY_END();
+}
@@ -0,0 +1,35 @@
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Host stand-in for the Arduino core, with only the serial port that remote
+ * control uses. Bytes to be received are queued in `rx`, and sent bytes are
+ * collected in `tx`.
+ */
+
+class SerialStub {
+public:
+    uint8_t rx[256];
+    size_t rx_len = 0;
+    size_t rx_pos = 0;
+    uint8_t tx[256];
+    size_t tx_len = 0;
+    /// Space left in the transmit buffer
+    int tx_free = 64;
+
+    void begin(unsigned long baud) { (void)baud; }
+    int availableForWrite() { return tx_free; }
+    int read() { return (rx_pos < rx_len) ? rx[rx_pos++] : -1; }
+    size_t write(const uint8_t *buffer, size_t len) {
+        memcpy(&tx[tx_len], buffer, len);
+        tx_len += len;
+        return len;
+    }
+};
+
+extern SerialStub Serial;
+
+#endif /* ARDUINO_H_ */
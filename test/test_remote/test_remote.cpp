@@ -0,0 +1,241 @@
+#include <unity.h>
+
+#include "config.h"
+// Test remote control even if it is disabled in the firmware. `config.h` is
+// include guarded, so these stay in effect for remote control.
+#undef SERIAL_REMOTE
+#define SERIAL_REMOTE 1
+#undef LOGGING_ENABLED
+#define LOGGING_ENABLED 0
+
+#include "remote.cpp"
+
+SerialStub Serial;
+
+/* MODE STUB */
+
+/// Largest value of every param
+#define VALUE_MAX 16
+#define NUM_POSITIONS 3
+
+static ModeState mode_state;
+static Params params;
+static bool cued;
+static uint8_t cued_values[PARAMS_MAX];
+
+bool mode_param_write(ModeState *state, Params *params, Mode mode, ParamIdx idx, uint8_t value) {
+    if (idx >= params->len || value > VALUE_MAX) return false;
+    params->values[idx] = value;
+    return true;
+}
+
+bool mode_params_cue(ModeState *state, Mode mode, const uint8_t *values) {
+    for (uint8_t idx = 0; idx < params.len; idx++) {
+        if (values[idx] > VALUE_MAX) return false;
+    }
+    memcpy(cued_values, values, params.len);
+    cued = true;
+    return true;
+}
+
+uint8_t mode_sequencer_positions(const ModeState *state, Mode mode, uint8_t *positions) {
+    for (uint8_t n = 0; n < NUM_POSITIONS; n++) {
+        positions[n] = 10 + n;
+    }
+    return NUM_POSITIONS;
+}
+
+/* HELPERS */
+
+/// Queue a command frame to be received
+static void command_send(uint8_t command, const uint8_t *payload, uint8_t len) {
+    Serial.rx_len += serial_frame_encode(&Serial.rx[Serial.rx_len], command, payload, len);
+}
+
+/// Run remote updates until every received byte has been decoded
+/// @return `true` if any update wrote params
+static bool remote_update_all(void) {
+    bool params_written = false;
+    while (Serial.rx_pos < Serial.rx_len) {
+        params_written |= remote_update(&mode_state, &params, MODE_EUCLID);
+    }
+    return params_written;
+}
+
+/// Decode the only response frame that was sent
+static const SerialFrame *response_take(void) {
+    static SerialFrameDecoder response_decoder;
+    serial_frame_decoder_init(&response_decoder);
+
+    uint8_t frames = 0;
+    for (size_t i = 0; i < Serial.tx_len; i++) {
+        if (serial_frame_decode(&response_decoder, Serial.tx[i])) frames++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, frames);
+    Serial.tx_len = 0;
+    return &response_decoder.frame;
+}
+
+static void response_error_check(uint8_t command, RemoteError error) {
+    const SerialFrame *response = response_take();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_RESPONSE_ERROR, response->command);
+    TEST_ASSERT_EQUAL_UINT8(2, response->len);
+    TEST_ASSERT_EQUAL_UINT8(command, response->payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(error, response->payload[1]);
+}
+
+void setUp(void) {
+    Serial = SerialStub();
+    params.len = PARAMS_MAX;
+    for (uint8_t idx = 0; idx < PARAMS_MAX; idx++) {
+        params.values[idx] = idx;
+    }
+    cued = false;
+    remote_init();
+}
+
+// required on Windows
+void tearDown(void) { }
+
+/* TESTS */
+
+void test_remote_param_get(void) {
+    const uint8_t payload[] = {4};
+    command_send(REMOTE_COMMAND_PARAM_GET, payload, sizeof(payload));
+    TEST_ASSERT_FALSE(remote_update_all());
+
+    const SerialFrame *response = response_take();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_COMMAND_PARAM_GET | REMOTE_RESPONSE_BIT, response->command);
+    TEST_ASSERT_EQUAL_UINT8(2, response->len);
+    TEST_ASSERT_EQUAL_UINT8(4, response->payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(4, response->payload[1]);
+}
+
+void test_remote_param_get_out_of_bounds(void) {
+    const uint8_t payload[] = {PARAMS_MAX};
+    command_send(REMOTE_COMMAND_PARAM_GET, payload, sizeof(payload));
+    remote_update_all();
+    response_error_check(REMOTE_COMMAND_PARAM_GET, REMOTE_ERROR_OUT_OF_BOUNDS);
+}
+
+void test_remote_param_set(void) {
+    const uint8_t payload[] = {2, 12};
+    command_send(REMOTE_COMMAND_PARAM_SET, payload, sizeof(payload));
+    TEST_ASSERT_TRUE(remote_update_all());
+    TEST_ASSERT_EQUAL_UINT8(12, params.values[2]);
+
+    const SerialFrame *response = response_take();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_COMMAND_PARAM_SET | REMOTE_RESPONSE_BIT, response->command);
+    TEST_ASSERT_EQUAL_UINT8(2, response->payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(12, response->payload[1]);
+}
+
+void test_remote_param_set_out_of_bounds(void) {
+    const uint8_t payload[] = {2, VALUE_MAX + 1};
+    command_send(REMOTE_COMMAND_PARAM_SET, payload, sizeof(payload));
+    TEST_ASSERT_FALSE(remote_update_all());
+    TEST_ASSERT_EQUAL_UINT8(2, params.values[2]);
+    response_error_check(REMOTE_COMMAND_PARAM_SET, REMOTE_ERROR_OUT_OF_BOUNDS);
+}
+
+void test_remote_wrong_length(void) {
+    const uint8_t payload[] = {2};
+    command_send(REMOTE_COMMAND_PARAM_SET, payload, sizeof(payload));
+    TEST_ASSERT_FALSE(remote_update_all());
+    response_error_check(REMOTE_COMMAND_PARAM_SET, REMOTE_ERROR_LENGTH);
+}
+
+void test_remote_unknown_command(void) {
+    command_send(0x7F, NULL, 0);
+    remote_update_all();
+    response_error_check(0x7F, REMOTE_ERROR_UNKNOWN_COMMAND);
+}
+
+void test_remote_params_get(void) {
+    command_send(REMOTE_COMMAND_PARAMS_GET, NULL, 0);
+    remote_update_all();
+
+    const SerialFrame *response = response_take();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_COMMAND_PARAMS_GET | REMOTE_RESPONSE_BIT, response->command);
+    TEST_ASSERT_EQUAL_UINT8(PARAMS_MAX, response->len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(params.values, response->payload, PARAMS_MAX);
+}
+
+void test_remote_params_cue(void) {
+    const uint8_t payload[PARAMS_MAX] = {16, 4, 0, 8, 3, 1, 12, 5, 2};
+    command_send(REMOTE_COMMAND_PARAMS_CUE, payload, sizeof(payload));
+    // Cued params aren't written until the next clock
+    TEST_ASSERT_FALSE(remote_update_all());
+    TEST_ASSERT_TRUE(cued);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, cued_values, PARAMS_MAX);
+
+    const SerialFrame *response = response_take();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_COMMAND_PARAMS_CUE | REMOTE_RESPONSE_BIT, response->command);
+    TEST_ASSERT_EQUAL_UINT8(0, response->len);
+}
+
+void test_remote_params_cue_out_of_bounds(void) {
+    const uint8_t payload[PARAMS_MAX] = {16, 4, 0, 8, 3, 1, 12, 5, VALUE_MAX + 1};
+    command_send(REMOTE_COMMAND_PARAMS_CUE, payload, sizeof(payload));
+    remote_update_all();
+    TEST_ASSERT_FALSE(cued);
+    response_error_check(REMOTE_COMMAND_PARAMS_CUE, REMOTE_ERROR_OUT_OF_BOUNDS);
+}
+
+void test_remote_positions_get(void) {
+    command_send(REMOTE_COMMAND_POSITIONS_GET, NULL, 0);
+    remote_update_all();
+
+    const SerialFrame *response = response_take();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_COMMAND_POSITIONS_GET | REMOTE_RESPONSE_BIT, response->command);
+    TEST_ASSERT_EQUAL_UINT8(NUM_POSITIONS, response->len);
+    TEST_ASSERT_EQUAL_UINT8(10, response->payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(12, response->payload[2]);
+}
+
+/// Each update decodes a limited number of bytes, so a long frame is decoded
+/// over several updates
+void test_remote_bytes_per_update(void) {
+    const uint8_t payload[PARAMS_MAX] = {0};
+    command_send(REMOTE_COMMAND_PARAMS_CUE, payload, sizeof(payload));
+
+    remote_update(&mode_state, &params, MODE_EUCLID);
+    TEST_ASSERT_EQUAL(SERIAL_REMOTE_BYTES_PER_UPDATE, Serial.rx_pos);
+    TEST_ASSERT_FALSE(cued);
+
+    remote_update_all();
+    TEST_ASSERT_TRUE(cued);
+}
+
+/// Nothing is decoded while the largest response wouldn't fit in the transmit
+/// buffer, so sending a response never waits
+void test_remote_transmit_buffer_full(void) {
+    command_send(REMOTE_COMMAND_PARAMS_GET, NULL, 0);
+    Serial.tx_free = RESPONSE_MAX - 1;
+    remote_update(&mode_state, &params, MODE_EUCLID);
+    TEST_ASSERT_EQUAL(0, Serial.rx_pos);
+    TEST_ASSERT_EQUAL(0, Serial.tx_len);
+
+    Serial.tx_free = RESPONSE_MAX;
+    remote_update_all();
+    TEST_ASSERT_EQUAL_UINT8(REMOTE_COMMAND_PARAMS_GET | REMOTE_RESPONSE_BIT, response_take()->command);
+}
+
+int main( int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_remote_param_get);
+    RUN_TEST(test_remote_param_get_out_of_bounds);
+    RUN_TEST(test_remote_param_set);
+    RUN_TEST(test_remote_param_set_out_of_bounds);
+    RUN_TEST(test_remote_wrong_length);
+    RUN_TEST(test_remote_unknown_command);
+    RUN_TEST(test_remote_params_get);
+    RUN_TEST(test_remote_params_cue);
+    RUN_TEST(test_remote_params_cue_out_of_bounds);
+    RUN_TEST(test_remote_positions_get);
+    RUN_TEST(test_remote_bytes_per_update);
+    RUN_TEST(test_remote_transmit_buffer_full);
+
+    UNITY_END();
+}
@@ -0,0 +1,144 @@
+#include <unity.h>
+
+#include <serial_frame.h>
+
+/* HELPERS */
+
+static SerialFrameDecoder decoder;
+
+/// Feed `len` bytes to the decoder
+/// @return Number of frames that were completed
+static uint8_t decode_all(const uint8_t *bytes, uint8_t len) {
+    uint8_t frames = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        if (serial_frame_decode(&decoder, bytes[i])) frames++;
+    }
+    return frames;
+}
+
+void setUp(void) {
+    serial_frame_decoder_init(&decoder);
+}
+
+// required on Windows
+void tearDown(void) { }
+
+/* TESTS */
+
+void test_frame_encode_layout(void) {
+    const uint8_t payload[] = {0x12, 0x34};
+    uint8_t out[SERIAL_FRAME_PAYLOAD_MAX + SERIAL_FRAME_OVERHEAD];
+    TEST_ASSERT_EQUAL_UINT8(2 + SERIAL_FRAME_OVERHEAD, serial_frame_encode(out, 0x02, payload, 2));
+    TEST_ASSERT_EQUAL_UINT8(SERIAL_FRAME_SYNC, out[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x02, out[1]);
+    TEST_ASSERT_EQUAL_UINT8(2, out[2]);
+    TEST_ASSERT_EQUAL_UINT8(0x12, out[3]);
+    TEST_ASSERT_EQUAL_UINT8(0x34, out[4]);
+}
+
+void test_frame_round_trip(void) {
+    uint8_t payload[SERIAL_FRAME_PAYLOAD_MAX];
+    uint8_t out[SERIAL_FRAME_PAYLOAD_MAX + SERIAL_FRAME_OVERHEAD];
+    for (uint8_t len = 0; len <= SERIAL_FRAME_PAYLOAD_MAX; len++) {
+        for (uint8_t i = 0; i < len; i++) {
+            // Include bytes equal to the sync byte, which aren't escaped
+            payload[i] = SERIAL_FRAME_SYNC + i;
+        }
+        const uint8_t frame_len = serial_frame_encode(out, len, payload, len);
+
+        TEST_ASSERT_EQUAL_UINT8(1, decode_all(out, frame_len));
+        TEST_ASSERT_EQUAL_UINT8(len, decoder.frame.command);
+        TEST_ASSERT_EQUAL_UINT8(len, decoder.frame.len);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, decoder.frame.payload, len);
+    }
+}
+
+/// Frames sent back to back are each decoded
+void test_frame_consecutive(void) {
+    const uint8_t payload[] = {1, 2, 3};
+    uint8_t out[2 * (3 + SERIAL_FRAME_OVERHEAD)];
+    uint8_t len = serial_frame_encode(out, 0x01, payload, 3);
+    len += serial_frame_encode(&out[len], 0x01, payload, 3);
+    TEST_ASSERT_EQUAL_UINT8(2, decode_all(out, len));
+}
+
+/// Bytes before a frame are discarded, even if they include the sync byte
+void test_frame_garbage_prefix(void) {
+    const uint8_t payload[] = {7, 8};
+    uint8_t out[8 + 2 + SERIAL_FRAME_OVERHEAD] = {0x00, 0x42, SERIAL_FRAME_SYNC, 0x10, 0xEE, SERIAL_FRAME_SYNC, 0xFF, 0x33};
+    const uint8_t len = 8 + serial_frame_encode(&out[8], 0x03, payload, 2);
+
+    TEST_ASSERT_EQUAL_UINT8(1, decode_all(out, len));
+    TEST_ASSERT_EQUAL_UINT8(0x03, decoder.frame.command);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, decoder.frame.payload, 2);
+}
+
+/// A frame cut short is discarded. It takes the start of the next frame with
+/// it, but decoding recovers by the frame after that.
+void test_frame_truncated(void) {
+    const uint8_t payload[] = {1, 2, 3, 4};
+    uint8_t out[3 * (4 + SERIAL_FRAME_OVERHEAD)];
+    uint8_t len = serial_frame_encode(out, 0x01, payload, 4) - 3;
+    len += serial_frame_encode(&out[len], 0x02, payload, 4);
+    len += serial_frame_encode(&out[len], 0x03, payload, 4);
+
+    TEST_ASSERT_EQUAL_UINT8(1, decode_all(out, len));
+    TEST_ASSERT_EQUAL_UINT8(0x03, decoder.frame.command);
+}
+
+/// A length over the maximum is rejected without waiting for its payload
+void test_frame_over_length(void) {
+    const uint8_t over_length[] = {SERIAL_FRAME_SYNC, 0x01, SERIAL_FRAME_PAYLOAD_MAX + 1};
+    TEST_ASSERT_EQUAL_UINT8(0, decode_all(over_length, sizeof(over_length)));
+    TEST_ASSERT_EQUAL(SERIAL_FRAME_FIELD_SYNC, decoder.next);
+
+    const uint8_t payload[] = {9};
+    uint8_t out[1 + SERIAL_FRAME_OVERHEAD];
+    const uint8_t len = serial_frame_encode(out, 0x05, payload, 1);
+    TEST_ASSERT_EQUAL_UINT8(1, decode_all(out, len));
+}
+
+/// A length equal to the sync byte is over the maximum, and starts a new frame
+void test_frame_over_length_sync(void) {
+    const uint8_t payload[] = {9};
+    uint8_t out[2 + 1 + SERIAL_FRAME_OVERHEAD] = {SERIAL_FRAME_SYNC, 0x01};
+    const uint8_t len = 2 + serial_frame_encode(&out[2], 0x05, payload, 1);
+    TEST_ASSERT_EQUAL_UINT8(1, decode_all(out, len));
+    TEST_ASSERT_EQUAL_UINT8(0x05, decoder.frame.command);
+}
+
+void test_frame_corrupt_crc(void) {
+    const uint8_t payload[] = {1, 2, 3};
+    uint8_t out[3 + SERIAL_FRAME_OVERHEAD];
+    const uint8_t len = serial_frame_encode(out, 0x01, payload, 3);
+    out[len - 1] ^= 0x01;
+    TEST_ASSERT_EQUAL_UINT8(0, decode_all(out, len));
+
+    // Restored, the same frame is decoded
+    out[len - 1] ^= 0x01;
+    TEST_ASSERT_EQUAL_UINT8(1, decode_all(out, len));
+}
+
+void test_frame_corrupt_payload(void) {
+    const uint8_t payload[] = {1, 2, 3};
+    uint8_t out[3 + SERIAL_FRAME_OVERHEAD];
+    const uint8_t len = serial_frame_encode(out, 0x01, payload, 3);
+    out[4] ^= 0x80;
+    TEST_ASSERT_EQUAL_UINT8(0, decode_all(out, len));
+}
+
+int main( int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_frame_encode_layout);
+    RUN_TEST(test_frame_round_trip);
+    RUN_TEST(test_frame_consecutive);
+    RUN_TEST(test_frame_garbage_prefix);
+    RUN_TEST(test_frame_truncated);
+    RUN_TEST(test_frame_over_length);
+    RUN_TEST(test_frame_over_length_sync);
+    RUN_TEST(test_frame_corrupt_crc);
+    RUN_TEST(test_frame_corrupt_payload);
+
+    UNITY_END();
+}